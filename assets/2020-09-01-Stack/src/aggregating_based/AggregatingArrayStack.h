@@ -0,0 +1,162 @@
+#ifndef AGGREGATING_ARRAY_STACK_H
+#define AGGREGATING_ARRAY_STACK_H
+
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include "../array_based/ArrayStack.h"
+
+using std::string;
+
+// associative operations for AggregatingArrayStack
+template<typename T>
+struct MinOp {
+    T operator()(const T &a, const T &b) const {
+        return std::min(a, b);
+    }
+};
+
+template<typename T>
+struct MaxOp {
+    T operator()(const T &a, const T &b) const {
+        return std::max(a, b);
+    }
+};
+
+template<typename T>
+using SumOp = std::plus<T>;
+
+/**
+ * Array based Stack with an O(1) aggregate
+ *
+ * Every slot stores the element together with the aggregate of all elements
+ * from the bottom up to it, so pop() never has to recompute anything and
+ * aggregate() is the aggregate stored on top.
+ *
+ * Op must be associative, it does not have to be commutative: aggregate()
+ * is Op(...Op(Op(bottom, second), third)..., top).
+ *
+ * @tparam T   generic type, copy constructible
+ * @tparam Op  associative binary function object, e.g. MinOp<T>, MaxOp<T>, SumOp<T>
+ */
+template<typename T, typename Op>
+class AggregatingArrayStack {
+public:
+    // constructor
+    explicit AggregatingArrayStack(size_t size = 100, Op op = Op());
+
+    /////////////////////////  Big Five  /////////////////////////
+    // all five are those of the underlying ArrayStack
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Principle Operations  ///////////////////
+    void push(const T &e);
+
+    T pop();
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Auxiliary Operations  ///////////////////
+    bool isEmpty() const;
+
+    size_t size() const;
+
+    const T& top() const;
+
+    // Op over every element, bottom to top
+    const T& aggregate() const;
+
+    void clear();
+
+    string toString() const;
+    //////////////////////////////////////////////////////////////
+
+private:
+    struct Entry {
+        T value;
+        // Op over the elements from the bottom up to this one
+        T aggregate;
+    };
+
+    ArrayStack<Entry> entries;
+
+    Op op;
+};
+
+///////////////////  Function Implementation  ///////////////////
+// constructor
+template<typename T, typename Op>
+AggregatingArrayStack<T, Op>::AggregatingArrayStack(size_t size, Op op) : entries {size}, op {std::move(op)} {
+}
+
+///////////////////  Principle Operations  ///////////////////
+template<typename T, typename Op>
+void AggregatingArrayStack<T, Op>::push(const T &e) {
+    if (entries.isEmpty()) {
+        entries.push(Entry {e, e});
+    } else {
+        // extend the aggregate below by the new element
+        entries.push(Entry {e, op(entries.top().aggregate, e)});
+    }
+}
+
+template<typename T, typename Op>
+T AggregatingArrayStack<T, Op>::pop() {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    // the aggregate below is already stored, nothing to recompute
+    return std::move(entries.pop().value);
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Operations  ///////////////////
+template<typename T, typename Op>
+bool AggregatingArrayStack<T, Op>::isEmpty() const {
+    return entries.isEmpty();
+}
+
+template<typename T, typename Op>
+size_t AggregatingArrayStack<T, Op>::size() const {
+    return entries.size();
+}
+
+template<typename T, typename Op>
+const T& AggregatingArrayStack<T, Op>::top() const {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return entries.top().value;
+}
+
+template<typename T, typename Op>
+const T& AggregatingArrayStack<T, Op>::aggregate() const {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return entries.top().aggregate;
+}
+
+template<typename T, typename Op>
+void AggregatingArrayStack<T, Op>::clear() {
+    entries.clear();
+}
+
+template<typename T, typename Op>
+string AggregatingArrayStack<T, Op>::toString() const {
+    if (isEmpty()) {
+        return "";
+    }
+
+    // the entries are contiguous below the top one, read them in place from top to bottom
+    const Entry *top = &entries.top();
+    string ret;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        ret += std::to_string((top - i)->value) + "\n";
+    }
+    return ret;
+}
+//////////////////////////////////////////////////////////////
+
+#endif //AGGREGATING_ARRAY_STACK_H
@@ -0,0 +1,148 @@
+#ifndef TWO_STACK_QUEUE_H
+#define TWO_STACK_QUEUE_H
+
+#include <utility>
+#include <stdexcept>
+#include "AggregatingArrayStack.h"
+
+/**
+ * FIFO queue with an O(1) aggregate, built from two AggregatingArrayStacks
+ *
+ * push() goes to the back stack. pop() takes from the front stack, and when
+ * that is empty the back stack is poured into it first, which reverses the
+ * order. Every element is moved once, so push and pop are amortized O(1), and
+ * aggregate() combines the two stack aggregates.
+ *
+ * As a sliding window: push every new sample, pop once the window is full,
+ * and read aggregate().
+ *
+ * @tparam T   generic type, copy constructible
+ * @tparam Op  associative binary function object, e.g. MinOp<T>, MaxOp<T>, SumOp<T>
+ */
+template<typename T, typename Op>
+class TwoStackQueue {
+public:
+    // constructor
+    explicit TwoStackQueue(size_t size = 100, Op op = Op());
+
+    ///////////////////  Principle Operations  ///////////////////
+    // append at the back
+    void push(const T &e);
+
+    // remove the front, the oldest element
+    T pop();
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Auxiliary Operations  ///////////////////
+    bool isEmpty() const;
+
+    size_t size() const;
+
+    const T& front();
+
+    // Op over every element, front to back
+    T aggregate() const;
+
+    void clear();
+    //////////////////////////////////////////////////////////////
+
+private:
+    // the front stack holds the oldest element on top, so its aggregate
+    // has to be built the other way round to stay in queue order
+    struct FlippedOp {
+        Op op;
+
+        T operator()(const T &below, const T &e) const {
+            return op(e, below);
+        }
+    };
+
+    AggregatingArrayStack<T, FlippedOp> frontStack;
+
+    AggregatingArrayStack<T, Op> backStack;
+
+    Op op;
+
+    ///////////////////  Auxiliary Functions  ////////////////////
+    void pour();
+    //////////////////////////////////////////////////////////////
+};
+
+///////////////////  Function Implementation  ///////////////////
+// constructor
+template<typename T, typename Op>
+TwoStackQueue<T, Op>::TwoStackQueue(size_t size, Op op) : frontStack {size, FlippedOp {op}}, backStack {size, op}, op {op} {
+}
+
+///////////////////  Principle Operations  ///////////////////
+template<typename T, typename Op>
+void TwoStackQueue<T, Op>::push(const T &e) {
+    backStack.push(e);
+}
+
+template<typename T, typename Op>
+T TwoStackQueue<T, Op>::pop() {
+    if (isEmpty()) {
+        throw std::runtime_error("Queue is empty.");
+    }
+    if (frontStack.isEmpty()) {
+        pour();
+    }
+    return frontStack.pop();
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Operations  ///////////////////
+template<typename T, typename Op>
+bool TwoStackQueue<T, Op>::isEmpty() const {
+    return frontStack.isEmpty() && backStack.isEmpty();
+}
+
+template<typename T, typename Op>
+size_t TwoStackQueue<T, Op>::size() const {
+    return frontStack.size() + backStack.size();
+}
+
+template<typename T, typename Op>
+const T& TwoStackQueue<T, Op>::front() {
+    if (isEmpty()) {
+        throw std::runtime_error("Queue is empty.");
+    }
+    if (frontStack.isEmpty()) {
+        pour();
+    }
+    return frontStack.top();
+}
+
+template<typename T, typename Op>
+T TwoStackQueue<T, Op>::aggregate() const {
+    if (isEmpty()) {
+        throw std::runtime_error("Queue is empty.");
+    }
+    if (frontStack.isEmpty()) {
+        return backStack.aggregate();
+    }
+    if (backStack.isEmpty()) {
+        return frontStack.aggregate();
+    }
+    return op(frontStack.aggregate(), backStack.aggregate());
+}
+
+template<typename T, typename Op>
+void TwoStackQueue<T, Op>::clear() {
+    frontStack.clear();
+    backStack.clear();
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Functions  ////////////////////
+template<typename T, typename Op>
+void TwoStackQueue<T, Op>::pour() {
+    // the newest element goes in first and ends up deepest
+    while (!backStack.isEmpty()) {
+        frontStack.push(backStack.pop());
+    }
+}
+//////////////////////////////////////////////////////////////
+
+#endif //TWO_STACK_QUEUE_H
@@ -0,0 +1,142 @@
+#include <iostream>
+#include <assert.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include "AggregatingArrayStack.h"
+#include "TwoStackQueue.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+
+void testAggregatingStack() {
+    // test constructor
+    AggregatingArrayStack<int, MinOp<int>> minStack{1};
+    assert(minStack.isEmpty() == true);
+    assert(minStack.toString() == "");
+
+    // test push, top, aggregate
+    minStack.push(5);
+    minStack.push(3);
+    minStack.push(8);
+    minStack.push(1);
+    assert(minStack.top() == 1);
+    assert(minStack.aggregate() == 1);
+    assert(minStack.size() == 4);
+    assert(minStack.toString() == "1\n8\n3\n5\n");
+
+    // test pop restores the aggregate below
+    assert(minStack.pop() == 1);
+    assert(minStack.aggregate() == 3);
+    assert(minStack.pop() == 8);
+    assert(minStack.pop() == 3);
+    assert(minStack.aggregate() == 5);
+
+    // test max and sum
+    AggregatingArrayStack<long, MaxOp<long>> maxStack;
+    AggregatingArrayStack<long, SumOp<long>> sumStack;
+    for (long i : {4, 9, 2}) {
+        maxStack.push(i);
+        sumStack.push(i);
+    }
+    assert(maxStack.aggregate() == 9);
+    assert(sumStack.aggregate() == 15);
+    sumStack.pop();
+    assert(sumStack.aggregate() == 13);
+
+    // test clear, aggregate and pop on an empty stack
+    minStack.clear();
+    bool thrown = false;
+    try {
+        minStack.aggregate();
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+    thrown = false;
+    try {
+        minStack.pop();
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+}
+
+struct Concat {
+    std::string operator()(const std::string &a, const std::string &b) const {
+        return a + b;
+    }
+};
+
+void testQueueOrder() {
+    // concatenation is associative but not commutative, the aggregate must keep queue order
+    TwoStackQueue<std::string, Concat> queue{2};
+    queue.push("a");
+    queue.push("b");
+    queue.push("c");
+    assert(queue.aggregate() == "abc");
+    assert(queue.front() == "a");
+    assert(queue.pop() == "a");
+    assert(queue.aggregate() == "bc");
+    queue.push("d");
+    queue.push("e");
+    assert(queue.aggregate() == "bcde");
+    assert(queue.size() == 4);
+    assert(queue.pop() == "b");
+    assert(queue.pop() == "c");
+    assert(queue.pop() == "d");
+    assert(queue.aggregate() == "e");
+    assert(queue.pop() == "e");
+    assert(queue.isEmpty() == true);
+
+    bool thrown = false;
+    try {
+        queue.pop();
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+}
+
+void testSlidingWindow() {
+    // windowed min/max/sum against a brute force scan
+    const size_t window = 37;
+    TwoStackQueue<int, MinOp<int>> minWindow;
+    TwoStackQueue<int, MaxOp<int>> maxWindow;
+    TwoStackQueue<long, SumOp<long>> sumWindow;
+    std::deque<int> samples;
+
+    unsigned seed = 12345;
+    for (int i = 0; i < 10000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int sample = static_cast<int>((seed >> 16) % 1000) - 500;
+        minWindow.push(sample);
+        maxWindow.push(sample);
+        sumWindow.push(sample);
+        samples.push_back(sample);
+        if (samples.size() > window) {
+            assert(minWindow.pop() == samples.front());
+            maxWindow.pop();
+            sumWindow.pop();
+            samples.pop_front();
+        }
+
+        long sum = 0;
+        for (int s : samples) {
+            sum += s;
+        }
+        assert(minWindow.aggregate() == *std::min_element(samples.begin(), samples.end()));
+        assert(maxWindow.aggregate() == *std::max_element(samples.begin(), samples.end()));
+        assert(sumWindow.aggregate() == sum);
+    }
+}
+
+int main() {
+    testAggregatingStack();
+    testQueueOrder();
+    testSlidingWindow();
+
+    return 0;
+}
@@ -2,19 +2,46 @@
 #define ARRAY_STACK_H
 
 #include <string>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <istream>
+#include <ostream>
+#include <memory>
+#include <utility>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
 #include <stdexcept>
+#include "GrowthPolicy.h"
+#include "StatsPolicy.h"
 
-using std::array;
 using std::string;
 
 /**
  * Array based Stack
  *
- * @tparam T  generic type
- *            assuming that T has implemented operator[], operator=, operator()
+ * The storage is allocated raw (uninitialized), elements are only constructed
+ * when they are pushed and destroyed when they are popped, so an empty slot
+ * of capacity costs no constructor call.
+ *
+ * When the stack is full, the capacity grows by GrowthPolicy and the elements
+ * are relocated: trivially copyable elements are moved as raw bytes with
+ * realloc (which may extend the block in place), the others are moved with
+ * std::move_if_noexcept so a throwing move falls back to copying.
+ *
+ * @tparam T             generic type
+ *                       assuming that T is move constructible or copy constructible
+ * @tparam GrowthPolicy  DoublingGrowth, HalfGrowth or ChunkGrowth<N>, see GrowthPolicy.h
+ * @tparam StatsPolicy   NoStats or CountingStats, see StatsPolicy.h
  */
-template <typename T>
-class ArrayStack {
+template <typename T, typename GrowthPolicy = DoublingGrowth, typename StatsPolicy = NoStats>
+class ArrayStack : private StatsPolicy {
 public:
     // constructor
     explicit ArrayStack(size_t size = 100);
@@ -37,9 +64,28 @@ public:
     //////////////////////////////////////////////////////////////
 
     ///////////////////  Principle Operations  ///////////////////
-    void push(T e);
+    void push(const T &e);
+
+    void push(T &&e);
+
+    // construct the new top element in place from args
+    template<typename... Args>
+    T& emplace(Args&&... args);
 
+    // move the top element out
     T pop();
+
+    // pop that reports an empty stack with std::nullopt instead of throwing
+    std::optional<T> tryPop() noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    // push [first, last) in order, *first ends up deepest
+    // capacity is grown at most once for forward iterators
+    template<typename InputIt>
+    void pushRange(InputIt first, InputIt last);
+
+    // pop n elements into out in pop order (top first), returns the end of the output
+    template<typename OutputIt>
+    OutputIt popN(size_t n, OutputIt out);
     //////////////////////////////////////////////////////////////
 
     ///////////////////  Auxiliary Operations  ///////////////////
@@ -49,54 +95,120 @@ public:
 
     size_t size() const;
 
-    T top() const;
+    T& top();
+
+    const T& top() const;
+
+    // top that reports an empty stack with nullptr instead of throwing
+    T* tryTop() noexcept;
+
+    const T* tryTop() const noexcept;
 
     void clear();
 
     string toString() const;
+
+    // number of chars toString() produces, computed without formatting integers
+    size_t formattedSize() const;
+
+    // toString() into buf, top first, one element per line
+    // returns the number of chars written, throws if bufSize < formattedSize()
+    size_t formatTo(char *buf, size_t bufSize) const;
+
+    // toString() into a stream through a fixed local buffer
+    void formatTo(std::ostream &os) const;
+
+    // checkpoint of the raw element array, trivially copyable T only
+    // layout: "ASTK", uint32 sizeof(T), uint64 count, count * sizeof(T) bytes
+    void saveBinary(std::ostream &os) const;
+
+    // replace the content with a checkpoint written by saveBinary
+    void loadBinary(std::istream &is);
+
+    size_t getCapacity() const;
+
+    // make room for at least n elements without further growth
+    void reserve(size_t n);
+
+    // release the unused capacity, e.g. after a spike has drained
+    void shrink_to_fit();
+
+    // counters of StatsPolicy plus the current depth and footprint
+    StackStats stats() const;
     //////////////////////////////////////////////////////////////
 
 
 private:
-    T *arr;
+    // elements that can be relocated as raw bytes through malloc/realloc/free
+    static constexpr bool isRelocatable = std::is_trivially_copyable<T>::value
+                                          && alignof(T) <= alignof(std::max_align_t);
+
+    T *arr {nullptr};
 
     size_t count {};
 
     size_t capacity {};
 
     ///////////////////  Auxiliary Functions  ////////////////////
+    static T* allocate(size_t n);
+
+    static void deallocate(T *p, size_t n);
+
+    void destroyElements();
+
     void deepcopy(const ArrayStack &);
 
     void deepmove(ArrayStack &);
 
-    void doublesize();
+    void reallocate(size_t newCapacity);
+
+    // move the elements into temp, a fresh block of newCapacity, then free the old block and adopt
+    // temp; a throwing copy destroys what it built in temp and leaves the stack untouched
+    void relocateInto(T *temp, size_t newCapacity);
+
+    void grow();
+
+    // enough for any value of T: an integer with sign, or a floating point number in fixed
+    // notation with sign, max_exponent10 + 1 integer digits, point and 6 decimals
+    static constexpr size_t MAX_ELEMENT_CHARS = std::is_floating_point<T>::value
+                                                ? static_cast<size_t>(std::numeric_limits<T>::max_exponent10) + 9
+                                                : static_cast<size_t>(std::numeric_limits<T>::digits10) + 3;
+
+    static size_t formattedLength(const T &e);
+
+    // returns the end of the written chars, nullptr if they do not fit
+    static char* formatElement(char *first, char *last, const T &e);
+
+    // the capacity GrowthPolicy reaches from the current one to fit at least n elements
+    size_t grownCapacity(size_t n) const;
     //////////////////////////////////////////////////////////////
 };
 
 ///////////////////  Function Implementation  ///////////////////
 // constructor
-template<typename T>
-ArrayStack<T>::ArrayStack(size_t size) : arr {new T[size]}, count {0}, capacity {size} {
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+ArrayStack<T, GrowthPolicy, StatsPolicy>::ArrayStack(size_t size) : arr {allocate(size)}, count {0}, capacity {size} {
 
 }
 
 /////////////////////////  Big Five  /////////////////////////
 // 1. destructor
-template<typename T>
-ArrayStack<T>::~ArrayStack() {
-    delete[] this->arr;
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+ArrayStack<T, GrowthPolicy, StatsPolicy>::~ArrayStack() {
+    destroyElements();
+    deallocate(this->arr, this->capacity);
     this->arr = nullptr;    // defensive programming
 }
 
 // 2. copy constructor
-template<typename T>
-ArrayStack<T>::ArrayStack(const ArrayStack &as) {
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+ArrayStack<T, GrowthPolicy, StatsPolicy>::ArrayStack(const ArrayStack &as) : StatsPolicy() {
     deepcopy(as);
 }
 
 // 3. copy assignment operator=
-template<typename T>
-ArrayStack<T>& ArrayStack<T>::operator=(const ArrayStack &as) {
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+ArrayStack<T, GrowthPolicy, StatsPolicy>& ArrayStack<T, GrowthPolicy, StatsPolicy>::operator=(const ArrayStack &as) {
     // check self-assignment
     if (this == &as) {
         return *this;
@@ -107,14 +219,14 @@ ArrayStack<T>& ArrayStack<T>::operator=(const ArrayStack &as) {
 }
 
 // 4. move constructor
-template<typename T>
-ArrayStack<T>::ArrayStack(ArrayStack &&as) noexcept {
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+ArrayStack<T, GrowthPolicy, StatsPolicy>::ArrayStack(ArrayStack &&as) noexcept : StatsPolicy() {
     deepmove(as);
 }
 
 // 5. move assignment operator=
-template<typename T>
-ArrayStack<T>& ArrayStack<T>::operator=(ArrayStack &&as) noexcept {
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+ArrayStack<T, GrowthPolicy, StatsPolicy>& ArrayStack<T, GrowthPolicy, StatsPolicy>::operator=(ArrayStack &&as) noexcept {
     // check self-assignment
     if (this == &as) {
         return *this;
@@ -127,118 +239,494 @@ ArrayStack<T>& ArrayStack<T>::operator=(ArrayStack &&as) noexcept {
 //////////////////////////////////////////////////////////////
 
 ///////////////////  Principle Operations  ///////////////////
-template<typename T>
-void ArrayStack<T>::push(T e) {
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::push(const T &e) {
+    emplace(e);
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::push(T &&e) {
+    emplace(std::move(e));
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+template<typename... Args>
+T& ArrayStack<T, GrowthPolicy, StatsPolicy>::emplace(Args&&... args) {
+    T *slot;
     if (isFull()) {
-        // double the capacity and copy
-        doublesize();
+        // args may refer into the array, as in push(top()), so build the value before
+        // the relocation frees it
+        T value(std::forward<Args>(args)...);
+        // grow the capacity and relocate
+        grow();
+        slot = ::new (static_cast<void *>(this->arr + this->count)) T(std::move(value));
+    } else {
+        // construct in the first unused slot, count is only bumped once construction succeeded
+        slot = ::new (static_cast<void *>(this->arr + this->count)) T(std::forward<Args>(args)...);
     }
-    this->arr[this->count++] = e;
+    this->count++;
+    this->onPush(1, this->count);
+    return *slot;
 }
 
-template<typename T>
-T ArrayStack<T>::pop() {
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+template<typename InputIt>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::pushRange(InputIt first, InputIt last) {
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value) {
+        size_t n = static_cast<size_t>(std::distance(first, last));
+        auto copyTo = [first, last, n](T *dest) {
+            if constexpr (isRelocatable && std::is_pointer<InputIt>::value
+                          && std::is_same<typename std::remove_cv<typename std::remove_pointer<InputIt>::type>::type, T>::value) {
+                // one block copy
+                if (n > 0) {
+                    std::memcpy(static_cast<void *>(dest), static_cast<const void *>(first), n * sizeof(T));
+                }
+            } else {
+                // all or nothing, uninitialized_copy destroys what it built if a copy throws
+                std::uninitialized_copy(first, last, dest);
+            }
+        };
+        if (this->count + n > this->capacity) {
+            // the range may lie in the array, as in pushRange(data(), data() + size()), so copy it
+            // into the new block before the old one is freed
+            size_t newCapacity = grownCapacity(this->count + n);
+            T *temp = allocate(newCapacity);
+            try {
+                copyTo(temp + this->count);
+            } catch (...) {
+                deallocate(temp, newCapacity);
+                throw;
+            }
+            try {
+                relocateInto(temp, newCapacity);
+            } catch (...) {
+                std::destroy(temp + this->count, temp + this->count + n);
+                deallocate(temp, newCapacity);
+                throw;
+            }
+        } else {
+            copyTo(this->arr + this->count);
+        }
+        this->count += n;
+        this->onPush(n, this->count);
+    } else {
+        // single pass iterator, the length is unknown
+        for (; first != last; ++first) {
+            emplace(*first);
+        }
+    }
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+template<typename OutputIt>
+OutputIt ArrayStack<T, GrowthPolicy, StatsPolicy>::popN(size_t n, OutputIt out) {
+    if (n > this->count) {
+        throw std::runtime_error("Stack has fewer elements than requested.");
+    }
+    T *first = this->arr + this->count - n;
+    T *last = this->arr + this->count;
+    // top first, the same order as n calls of pop()
+    out = std::move(std::make_reverse_iterator(last), std::make_reverse_iterator(first), out);
+    std::destroy(first, last);
+    this->count -= n;
+    this->onPop(n);
+    return out;
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+T ArrayStack<T, GrowthPolicy, StatsPolicy>::pop() {
     if (isEmpty()) {
         throw std::runtime_error("Stack is empty.");
     }
-    T ret = this->arr[this->count - 1];
+    T *slot = this->arr + this->count - 1;
+    T ret {std::move(*slot)};
+    slot->~T();
     this->count--;
+    this->onPop(1);
+    return ret;
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+std::optional<T> ArrayStack<T, GrowthPolicy, StatsPolicy>::tryPop() noexcept(std::is_nothrow_move_constructible<T>::value) {
+    if (isEmpty()) {
+        return std::nullopt;
+    }
+    T *slot = this->arr + this->count - 1;
+    std::optional<T> ret {std::move(*slot)};
+    slot->~T();
+    this->count--;
+    this->onPop(1);
     return ret;
 }
 //////////////////////////////////////////////////////////////
 
 ///////////////////  Auxiliary Operations  ///////////////////
-template<typename T>
-bool ArrayStack<T>::isEmpty() const {
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+bool ArrayStack<T, GrowthPolicy, StatsPolicy>::isEmpty() const {
     return this->size() == 0;
 }
 
-template<typename T>
-bool ArrayStack<T>::isFull() const {
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+bool ArrayStack<T, GrowthPolicy, StatsPolicy>::isFull() const {
     return this->size() == this->capacity;
 }
 
-template<typename T>
-size_t ArrayStack<T>::size() const {
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+size_t ArrayStack<T, GrowthPolicy, StatsPolicy>::size() const {
     return this->count;
 }
 
-template<typename T>
-T ArrayStack<T>::top() const {
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+T& ArrayStack<T, GrowthPolicy, StatsPolicy>::top() {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return this->arr[this->count - 1];
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+const T& ArrayStack<T, GrowthPolicy, StatsPolicy>::top() const {
     if (isEmpty()) {
         throw std::runtime_error("Stack is empty.");
     }
     return this->arr[this->count - 1];
 }
 
-template<typename T>
-void ArrayStack<T>::clear() {
-    this->count = 0;
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+T* ArrayStack<T, GrowthPolicy, StatsPolicy>::tryTop() noexcept {
+    return isEmpty() ? nullptr : this->arr + this->count - 1;
 }
 
-template<typename T>
-string ArrayStack<T>::toString() const {
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+const T* ArrayStack<T, GrowthPolicy, StatsPolicy>::tryTop() const noexcept {
+    return isEmpty() ? nullptr : this->arr + this->count - 1;
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::clear() {
+    destroyElements();
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+size_t ArrayStack<T, GrowthPolicy, StatsPolicy>::getCapacity() const {
+    return this->capacity;
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::reserve(size_t n) {
+    if (n > this->capacity) {
+        reallocate(n);
+    }
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::shrink_to_fit() {
+    reallocate(this->count);
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+StackStats ArrayStack<T, GrowthPolicy, StatsPolicy>::stats() const {
+    StackStats ret = StatsPolicy::snapshot();
+    ret.depth = this->count;
+    ret.footprintBytes = this->capacity * sizeof(T);
+    return ret;
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+string ArrayStack<T, GrowthPolicy, StatsPolicy>::toString() const {
     if (isEmpty()) {
         return "";
     }
 
-    string ret;
-    for (int i = count - 1; i >= 0; --i) {
-        ret += std::to_string(this->arr[i]) + "\n";
+    // one allocation of the exact size
+    string ret(formattedSize(), '\0');
+    formatTo(&ret[0], ret.size());
+    return ret;
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+size_t ArrayStack<T, GrowthPolicy, StatsPolicy>::formattedSize() const {
+    size_t ret = 0;
+    for (size_t i = 0; i < this->count; ++i) {
+        // value and "\n"
+        ret += formattedLength(this->arr[i]) + 1;
     }
     return ret;
 }
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+size_t ArrayStack<T, GrowthPolicy, StatsPolicy>::formatTo(char *buf, size_t bufSize) const {
+    char *it = buf;
+    char *last = buf + bufSize;
+    for (size_t i = this->count; i-- > 0; ) {
+        it = formatElement(it, last, this->arr[i]);
+        if (it == nullptr || it == last) {
+            throw std::runtime_error("Buffer is too small.");
+        }
+        *it++ = '\n';
+    }
+    return static_cast<size_t>(it - buf);
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::formatTo(std::ostream &os) const {
+    char buf[std::max<size_t>(8192, 2 * (MAX_ELEMENT_CHARS + 1))];
+    char *it = buf;
+    for (size_t i = this->count; i-- > 0; ) {
+        if (static_cast<size_t>(buf + sizeof(buf) - it) < MAX_ELEMENT_CHARS + 1) {
+            // flush the full buffer
+            os.write(buf, it - buf);
+            it = buf;
+        }
+        it = formatElement(it, buf + sizeof(buf), this->arr[i]);
+        if (it == nullptr) {
+            throw std::runtime_error("Element is too long to format.");
+        }
+        *it++ = '\n';
+    }
+    os.write(buf, it - buf);
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::saveBinary(std::ostream &os) const {
+    static_assert(std::is_trivially_copyable<T>::value, "saveBinary needs a trivially copyable T.");
+    uint32_t elementSize = sizeof(T);
+    uint64_t elementCount = this->count;
+    os.write("ASTK", 4);
+    os.write(reinterpret_cast<const char *>(&elementSize), sizeof(elementSize));
+    os.write(reinterpret_cast<const char *>(&elementCount), sizeof(elementCount));
+    // one block write of the whole element array
+    os.write(reinterpret_cast<const char *>(this->arr), static_cast<std::streamsize>(this->count * sizeof(T)));
+    if (!os) {
+        throw std::runtime_error("Failed to write stack checkpoint.");
+    }
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::loadBinary(std::istream &is) {
+    static_assert(std::is_trivially_copyable<T>::value, "loadBinary needs a trivially copyable T.");
+    char magic[4];
+    uint32_t elementSize = 0;
+    uint64_t elementCount = 0;
+    is.read(magic, 4);
+    is.read(reinterpret_cast<char *>(&elementSize), sizeof(elementSize));
+    is.read(reinterpret_cast<char *>(&elementCount), sizeof(elementCount));
+    if (!is || std::string(magic, 4) != "ASTK" || elementSize != sizeof(T)) {
+        throw std::runtime_error("Invalid stack checkpoint.");
+    }
+
+    clear();
+    reserve(static_cast<size_t>(elementCount));
+    // one block read straight into the element array
+    is.read(reinterpret_cast<char *>(this->arr), static_cast<std::streamsize>(elementCount * sizeof(T)));
+    if (!is) {
+        throw std::runtime_error("Truncated stack checkpoint.");
+    }
+    this->count = static_cast<size_t>(elementCount);
+    this->onPush(this->count, this->count);
+}
 //////////////////////////////////////////////////////////////
 
 ///////////////////  Auxiliary Functions  ////////////////////
-template<typename T>
-void ArrayStack<T>::deepcopy(const ArrayStack &as) {
-    // de-allocation
-    delete[] this->arr;
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+T* ArrayStack<T, GrowthPolicy, StatsPolicy>::allocate(size_t n) {
+    // raw storage only, no T is constructed here
+    if (n == 0) {
+        return nullptr;
+    }
+    if constexpr (isRelocatable) {
+        void *p = std::malloc(n * sizeof(T));
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(p);
+    } else {
+        return std::allocator<T>{}.allocate(n);
+    }
+}
 
-    this->arr = new T[as.count];
-    // element-wise copy
-    for (size_t i = 0; i < as.count; ++i) {
-        this->arr[i] = as.arr[i];
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::deallocate(T *p, size_t n) {
+    if (p == nullptr) {
+        return;
     }
-    this->count = as.count;
+    if constexpr (isRelocatable) {
+        std::free(p);
+    } else {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::destroyElements() {
+    // destroy from top to bottom, the reverse order of construction
+    while (this->count > 0) {
+        this->arr[--this->count].~T();
+    }
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::deepcopy(const ArrayStack &as) {
+    // de-allocation
+    destroyElements();
+    deallocate(this->arr, this->capacity);
+    this->arr = nullptr;
+    this->capacity = 0;
+
+    this->arr = allocate(as.capacity);
     this->capacity = as.capacity;
+    // element-wise copy construction into the raw storage
+    std::uninitialized_copy(as.arr, as.arr + as.count, this->arr);
+    this->count = as.count;
+    this->onPush(this->count, this->count);
 }
 
-template<typename T>
-void ArrayStack<T>::deepmove(ArrayStack &as) {
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::deepmove(ArrayStack &as) {
     // de-allocation
-    delete[] this->arr;
+    destroyElements();
+    deallocate(this->arr, this->capacity);
 
-    this->arr = new T[as.count];
-    // element-wise move
-    for (size_t i = 0; i < as.count; ++i) {
-        this->arr[i] = std::move(as.arr[i]);
-    }
+    // steal the storage, no element is touched
+    this->arr = as.arr;
     this->count = as.count;
     this->capacity = as.capacity;
 
     // reset as to stable state
     as.arr = nullptr;
     as.count = 0;
+    as.capacity = 0;
 }
 
-template<typename T>
-void ArrayStack<T>::doublesize() {
-    size_t doubleCapacity = 2 * this->capacity;
-    this->capacity = doubleCapacity;
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::reallocate(size_t newCapacity) {
+    // never drop live elements
+    if (newCapacity < this->count) {
+        newCapacity = this->count;
+    }
+    if (newCapacity == this->capacity) {
+        return;
+    }
 
-    // allocate new array
-    T *temp = this->arr;
-    this->arr = new T[doubleCapacity];
+    if constexpr (isRelocatable) {
+        // raw byte relocation, realloc may grow or shrink the block in place
+        if (newCapacity == 0) {
+            deallocate(this->arr, this->capacity);
+            this->arr = nullptr;
+        } else {
+            void *p = std::realloc(this->arr, newCapacity * sizeof(T));
+            if (p == nullptr) {
+                // the old block is still valid
+                throw std::bad_alloc();
+            }
+            this->arr = static_cast<T *>(p);
+        }
+        if (newCapacity > this->capacity) {
+            this->onGrow(1);
+        }
+        // realloc may not have moved the block, count the worst case
+        this->onRelocate(this->count * sizeof(T));
+        this->capacity = newCapacity;
+    } else {
+        T *temp = allocate(newCapacity);
+        try {
+            relocateInto(temp, newCapacity);
+        } catch (...) {
+            deallocate(temp, newCapacity);
+            throw;
+        }
+    }
+}
 
-    // element-wise copy
-    for (size_t i = 0; i < this->count; ++i) {
-        this->arr[i] = temp[i];
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::relocateInto(T *temp, size_t newCapacity) {
+    if constexpr (isRelocatable) {
+        // raw byte relocation
+        if (this->count > 0) {
+            std::memcpy(static_cast<void *>(temp), static_cast<const void *>(this->arr), this->count * sizeof(T));
+        }
+    } else {
+        // element-wise move construction, copy if the move may throw
+        size_t i = 0;
+        try {
+            for (; i < this->count; ++i) {
+                ::new (static_cast<void *>(temp + i)) T(std::move_if_noexcept(this->arr[i]));
+            }
+        } catch (...) {
+            // only reachable through a throwing copy, the old elements are untouched
+            std::destroy(temp, temp + i);
+            throw;
+        }
+        std::destroy(this->arr, this->arr + this->count);
     }
 
     // de-allocation
-    delete temp;
+    deallocate(this->arr, this->capacity);
+    this->arr = temp;
+    if (newCapacity > this->capacity) {
+        this->onGrow(1);
+    }
+    this->onRelocate(this->count * sizeof(T));
+    this->capacity = newCapacity;
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+void ArrayStack<T, GrowthPolicy, StatsPolicy>::grow() {
+    reallocate(GrowthPolicy::grow(this->capacity));
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+size_t ArrayStack<T, GrowthPolicy, StatsPolicy>::formattedLength(const T &e) {
+    if constexpr (std::is_integral<T>::value && !std::is_same<T, bool>::value) {
+        // count the digits, no formatting needed
+        using Unsigned = typename std::make_unsigned<T>::type;
+        size_t length = 1;
+        Unsigned magnitude = static_cast<Unsigned>(e);
+        if constexpr (std::is_signed<T>::value) {
+            if (e < 0) {
+                length++;
+                magnitude = static_cast<Unsigned>(Unsigned(0) - magnitude);
+            }
+        }
+        while (magnitude >= 10) {
+            magnitude /= 10;
+            length++;
+        }
+        return length;
+    } else {
+        // floating point: measure by formatting into scratch space
+        char scratch[MAX_ELEMENT_CHARS];
+        char *end = formatElement(scratch, scratch + sizeof(scratch), e);
+        if (end == nullptr) {
+            throw std::runtime_error("Element is too long to format.");
+        }
+        return static_cast<size_t>(end - scratch);
+    }
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+char* ArrayStack<T, GrowthPolicy, StatsPolicy>::formatElement(char *first, char *last, const T &e) {
+    std::to_chars_result res {};
+    if constexpr (std::is_same<T, bool>::value) {
+        res = std::to_chars(first, last, static_cast<int>(e));
+    } else if constexpr (std::is_floating_point<T>::value) {
+        // the same text as std::to_string, i.e. "%f"
+        res = std::to_chars(first, last, e, std::chars_format::fixed, 6);
+    } else {
+        res = std::to_chars(first, last, e);
+    }
+    return res.ec == std::errc() ? res.ptr : nullptr;
+}
+
+template<typename T, typename GrowthPolicy, typename StatsPolicy>
+size_t ArrayStack<T, GrowthPolicy, StatsPolicy>::grownCapacity(size_t n) const {
+    // follow the policy so that a later push sees the same capacities as element-wise pushes
+    size_t newCapacity = this->capacity;
+    while (newCapacity < n) {
+        newCapacity = GrowthPolicy::grow(newCapacity);
+    }
+    return newCapacity;
 }
 //////////////////////////////////////////////////////////////
 
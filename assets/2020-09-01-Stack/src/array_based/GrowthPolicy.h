@@ -0,0 +1,40 @@
+#ifndef GROWTH_POLICY_H
+#define GROWTH_POLICY_H
+
+#include <cstddef>
+
+/**
+ * Growth policies for array based containers
+ *
+ * A policy only decides the next capacity, the container does the relocation.
+ * grow(capacity) must always return a value greater than capacity, so that a
+ * zero capacity container is still able to grow.
+ */
+
+// multiply the capacity by 2, amortized O(1) push with at most 2x slack
+struct DoublingGrowth {
+    static size_t grow(size_t capacity) {
+        return capacity == 0 ? 1 : 2 * capacity;
+    }
+};
+
+// multiply the capacity by 1.5, lower peak memory than doubling
+// and lets the allocator reuse previously freed blocks
+struct HalfGrowth {
+    static size_t grow(size_t capacity) {
+        return capacity < 2 ? capacity + 1 : capacity + capacity / 2;
+    }
+};
+
+// increase the capacity by a constant CHUNK, O(N^2) copies in total
+// but the slack never exceeds CHUNK elements
+template<size_t CHUNK>
+struct ChunkGrowth {
+    static_assert(CHUNK > 0, "ChunkGrowth needs a positive chunk size.");
+
+    static size_t grow(size_t capacity) {
+        return capacity + CHUNK;
+    }
+};
+
+#endif //GROWTH_POLICY_H
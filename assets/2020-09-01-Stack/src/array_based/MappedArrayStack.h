@@ -0,0 +1,471 @@
+#ifndef MAPPED_ARRAY_STACK_H
+#define MAPPED_ARRAY_STACK_H
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <utility>
+#include <type_traits>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "GrowthPolicy.h"
+
+using std::string;
+
+/**
+ * Array based Stack stored in a memory-mapped file
+ *
+ * Same interface as ArrayStack, for stacks that may outgrow RAM: the element
+ * array is a shared mapping of a file, so the page cache writes cold pages
+ * back to disk instead of the process running out of memory.
+ *
+ * Growth extends the file with ftruncate and the mapping with mremap, no
+ * element is copied. When the stack has shrunk by more than DROP_THRESHOLD
+ * bytes below the highest page written, the popped pages are handed back
+ * with madvise (MADV_REMOVE frees their disk blocks as well where the file
+ * system supports it).
+ *
+ * The file keeps the stack across restarts: the constructor reopens an
+ * existing file, the element count in its header is updated by sync() and
+ * by the destructor.
+ *
+ * file layout: "MSTK", uint32 sizeof(T), uint64 count, padding up to
+ *              DATA_OFFSET, then the element array
+ *
+ * @tparam T             generic type, must be trivially copyable
+ * @tparam GrowthPolicy  DoublingGrowth, HalfGrowth or ChunkGrowth<N>, see GrowthPolicy.h
+ */
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+class MappedArrayStack {
+    static_assert(std::is_trivially_copyable<T>::value, "MappedArrayStack needs a trivially copyable T.");
+    static_assert(alignof(T) <= 4096, "MappedArrayStack needs an alignment of at most a page.");
+
+public:
+    // constructor, opens path or creates it with room for size elements
+    // reopen == false discards the previous content of the file
+    explicit MappedArrayStack(const string &path, size_t size = 4096, bool reopen = true);
+
+    /////////////////////////  Big Five  /////////////////////////
+    // 1. destructor, syncs the header and keeps the file
+    virtual ~MappedArrayStack();
+
+    // 2. / 3. copy: a file has one owner
+    MappedArrayStack(const MappedArrayStack &) = delete;
+
+    MappedArrayStack& operator=(const MappedArrayStack &) = delete;
+
+    // 4. move constructor
+    MappedArrayStack(MappedArrayStack &&) noexcept;
+
+    // 5. move assignment operator=
+    MappedArrayStack& operator=(MappedArrayStack &&) noexcept;
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Principle Operations  ///////////////////
+    void push(const T &e);
+
+    // construct the new top element in place from args
+    template<typename... Args>
+    T& emplace(Args&&... args);
+
+    T pop();
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Auxiliary Operations  ///////////////////
+    bool isEmpty() const;
+
+    bool isFull() const;
+
+    size_t size() const;
+
+    T& top();
+
+    const T& top() const;
+
+    void clear();
+
+    string toString() const;
+
+    size_t getCapacity() const;
+
+    // make room for at least n elements without further growth
+    void reserve(size_t n);
+
+    // write the element count to the header and flush the mapping to disk
+    void sync();
+
+    // give the pages above the top element back to the OS
+    void dropUnused();
+    //////////////////////////////////////////////////////////////
+
+private:
+    // offset of the element array in the file, a page on every common system
+    static constexpr size_t DATA_OFFSET = 4096;
+
+    // popped bytes tolerated before dropUnused() is called by pop()
+    static constexpr size_t DROP_THRESHOLD = size_t(1) << 20;
+
+    struct Header {
+        char magic[4];
+        uint32_t elementSize;
+        uint64_t count;
+    };
+
+    int fd {-1};
+
+    // the whole mapping, header included
+    char *base {nullptr};
+
+    size_t mappedBytes {};
+
+    T *arr {nullptr};
+
+    size_t count {};
+
+    size_t capacity {};
+
+    // end of the highest element written since the last drop
+    size_t highWater {};
+
+    ///////////////////  Auxiliary Functions  ////////////////////
+    static size_t pageSize();
+
+    static size_t roundUp(size_t bytes);
+
+    [[noreturn]] static void fail(const char *what);
+
+    // resize the file and the mapping for at least newCapacity elements
+    void remap(size_t newCapacity);
+
+    void grow();
+
+    void writeHeader();
+
+    // write the header back, then release
+    void close() noexcept;
+
+    // unmap and close the file without writing to it, all a failed constructor may do
+    void release() noexcept;
+
+    void deepmove(MappedArrayStack &);
+    //////////////////////////////////////////////////////////////
+};
+
+///////////////////  Function Implementation  ///////////////////
+// constructor
+template<typename T, typename GrowthPolicy>
+MappedArrayStack<T, GrowthPolicy>::MappedArrayStack(const string &path, size_t size, bool reopen) {
+    this->fd = ::open(path.c_str(), O_RDWR | O_CREAT | (reopen ? 0 : O_TRUNC), 0644);
+    if (this->fd < 0) {
+        fail("Failed to open stack file");
+    }
+    struct stat st {};
+    if (::fstat(this->fd, &st) != 0) {
+        int err = errno;
+        ::close(this->fd);
+        errno = err;
+        fail("Failed to stat stack file");
+    }
+
+    try {
+        if (st.st_size == 0) {
+            // a new stack
+            remap(size > 0 ? size : 1);
+            writeHeader();
+        } else {
+            // reopen, the file size gives the capacity
+            if (static_cast<size_t>(st.st_size) < DATA_OFFSET + sizeof(T)) {
+                throw std::runtime_error("Invalid stack file.");
+            }
+            remap((static_cast<size_t>(st.st_size) - DATA_OFFSET) / sizeof(T));
+            Header header {};
+            std::memcpy(&header, this->base, sizeof(header));
+            if (std::memcmp(header.magic, "MSTK", 4) != 0 || header.elementSize != sizeof(T)
+                || header.count > this->capacity) {
+                throw std::runtime_error("Invalid stack file.");
+            }
+            this->count = static_cast<size_t>(header.count);
+            this->highWater = this->count * sizeof(T);
+        }
+    } catch (...) {
+        // the file may belong to another stack, leave its header alone
+        release();
+        throw;
+    }
+}
+
+/////////////////////////  Big Five  /////////////////////////
+// 1. destructor
+template<typename T, typename GrowthPolicy>
+MappedArrayStack<T, GrowthPolicy>::~MappedArrayStack() {
+    close();
+}
+
+// 4. move constructor
+template<typename T, typename GrowthPolicy>
+MappedArrayStack<T, GrowthPolicy>::MappedArrayStack(MappedArrayStack &&ms) noexcept {
+    deepmove(ms);
+}
+
+// 5. move assignment operator=
+template<typename T, typename GrowthPolicy>
+MappedArrayStack<T, GrowthPolicy>& MappedArrayStack<T, GrowthPolicy>::operator=(MappedArrayStack &&ms) noexcept {
+    // check self-assignment
+    if (this == &ms) {
+        return *this;
+    }
+
+    close();
+    deepmove(ms);
+    return *this;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Principle Operations  ///////////////////
+template<typename T, typename GrowthPolicy>
+void MappedArrayStack<T, GrowthPolicy>::push(const T &e) {
+    emplace(e);
+}
+
+template<typename T, typename GrowthPolicy>
+template<typename... Args>
+T& MappedArrayStack<T, GrowthPolicy>::emplace(Args&&... args) {
+    T *slot;
+    if (isFull()) {
+        // args may refer into the mapping, as in push(top()), and the remap may move it:
+        // build the value first
+        T value(std::forward<Args>(args)...);
+        // extend the file and the mapping, nothing is copied
+        grow();
+        slot = ::new (static_cast<void *>(this->arr + this->count)) T(std::move(value));
+    } else {
+        slot = ::new (static_cast<void *>(this->arr + this->count)) T(std::forward<Args>(args)...);
+    }
+    this->count++;
+    if (this->count * sizeof(T) > this->highWater) {
+        this->highWater = this->count * sizeof(T);
+    }
+    return *slot;
+}
+
+template<typename T, typename GrowthPolicy>
+T MappedArrayStack<T, GrowthPolicy>::pop() {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    T ret {this->arr[this->count - 1]};
+    this->count--;
+    if (this->highWater - this->count * sizeof(T) > DROP_THRESHOLD) {
+        dropUnused();
+    }
+    return ret;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Operations  ///////////////////
+template<typename T, typename GrowthPolicy>
+bool MappedArrayStack<T, GrowthPolicy>::isEmpty() const {
+    return this->count == 0;
+}
+
+template<typename T, typename GrowthPolicy>
+bool MappedArrayStack<T, GrowthPolicy>::isFull() const {
+    return this->count == this->capacity;
+}
+
+template<typename T, typename GrowthPolicy>
+size_t MappedArrayStack<T, GrowthPolicy>::size() const {
+    return this->count;
+}
+
+template<typename T, typename GrowthPolicy>
+T& MappedArrayStack<T, GrowthPolicy>::top() {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return this->arr[this->count - 1];
+}
+
+template<typename T, typename GrowthPolicy>
+const T& MappedArrayStack<T, GrowthPolicy>::top() const {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return this->arr[this->count - 1];
+}
+
+template<typename T, typename GrowthPolicy>
+void MappedArrayStack<T, GrowthPolicy>::clear() {
+    // trivially copyable, nothing to destroy
+    this->count = 0;
+    dropUnused();
+}
+
+template<typename T, typename GrowthPolicy>
+string MappedArrayStack<T, GrowthPolicy>::toString() const {
+    if (isEmpty()) {
+        return "";
+    }
+
+    string ret;
+    for (size_t i = this->count; i-- > 0; ) {
+        ret += std::to_string(this->arr[i]) + "\n";
+    }
+    return ret;
+}
+
+template<typename T, typename GrowthPolicy>
+size_t MappedArrayStack<T, GrowthPolicy>::getCapacity() const {
+    return this->capacity;
+}
+
+template<typename T, typename GrowthPolicy>
+void MappedArrayStack<T, GrowthPolicy>::reserve(size_t n) {
+    if (n > this->capacity) {
+        remap(n);
+    }
+}
+
+template<typename T, typename GrowthPolicy>
+void MappedArrayStack<T, GrowthPolicy>::sync() {
+    writeHeader();
+    if (::msync(this->base, this->mappedBytes, MS_SYNC) != 0) {
+        fail("Failed to sync stack file");
+    }
+}
+
+template<typename T, typename GrowthPolicy>
+void MappedArrayStack<T, GrowthPolicy>::dropUnused() {
+    size_t from = roundUp(DATA_OFFSET + this->count * sizeof(T));
+    size_t to = roundUp(DATA_OFFSET + this->highWater);
+    if (from < to) {
+        // MADV_REMOVE punches a hole in the file, a plain drop keeps the disk blocks
+#ifdef MADV_REMOVE
+        if (::madvise(this->base + from, to - from, MADV_REMOVE) != 0)
+#endif
+        {
+            ::madvise(this->base + from, to - from, MADV_DONTNEED);
+        }
+    }
+    this->highWater = this->count * sizeof(T);
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Functions  ////////////////////
+template<typename T, typename GrowthPolicy>
+size_t MappedArrayStack<T, GrowthPolicy>::pageSize() {
+    static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return page;
+}
+
+template<typename T, typename GrowthPolicy>
+size_t MappedArrayStack<T, GrowthPolicy>::roundUp(size_t bytes) {
+    size_t page = pageSize();
+    return (bytes + page - 1) / page * page;
+}
+
+template<typename T, typename GrowthPolicy>
+void MappedArrayStack<T, GrowthPolicy>::fail(const char *what) {
+    throw std::runtime_error(string(what) + ": " + std::strerror(errno));
+}
+
+template<typename T, typename GrowthPolicy>
+void MappedArrayStack<T, GrowthPolicy>::remap(size_t newCapacity) {
+    // whole pages, the slack at the end becomes capacity
+    size_t newBytes = roundUp(DATA_OFFSET + newCapacity * sizeof(T));
+    if (newBytes == this->mappedBytes) {
+        return;
+    }
+    if (::ftruncate(this->fd, static_cast<off_t>(newBytes)) != 0) {
+        fail("Failed to resize stack file");
+    }
+
+    void *p;
+    if (this->base == nullptr) {
+        p = ::mmap(nullptr, newBytes, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+    } else {
+#ifdef __linux__
+        // the kernel moves the page table entries, the data stays where it is
+        p = ::mremap(this->base, this->mappedBytes, newBytes, MREMAP_MAYMOVE);
+#else
+        ::munmap(this->base, this->mappedBytes);
+        this->base = nullptr;
+        p = ::mmap(nullptr, newBytes, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+#endif
+    }
+    if (p == MAP_FAILED) {
+        fail("Failed to map stack file");
+    }
+
+    this->base = static_cast<char *>(p);
+    this->mappedBytes = newBytes;
+    this->arr = reinterpret_cast<T *>(this->base + DATA_OFFSET);
+    this->capacity = (newBytes - DATA_OFFSET) / sizeof(T);
+}
+
+template<typename T, typename GrowthPolicy>
+void MappedArrayStack<T, GrowthPolicy>::grow() {
+    remap(GrowthPolicy::grow(this->capacity));
+}
+
+template<typename T, typename GrowthPolicy>
+void MappedArrayStack<T, GrowthPolicy>::writeHeader() {
+    Header header {};
+    std::memcpy(header.magic, "MSTK", 4);
+    header.elementSize = sizeof(T);
+    header.count = this->count;
+    std::memcpy(this->base, &header, sizeof(header));
+}
+
+template<typename T, typename GrowthPolicy>
+void MappedArrayStack<T, GrowthPolicy>::close() noexcept {
+    if (this->base != nullptr) {
+        writeHeader();
+    }
+    release();
+}
+
+template<typename T, typename GrowthPolicy>
+void MappedArrayStack<T, GrowthPolicy>::release() noexcept {
+    if (this->base != nullptr) {
+        ::munmap(this->base, this->mappedBytes);
+    }
+    if (this->fd >= 0) {
+        ::close(this->fd);
+    }
+    this->fd = -1;
+    this->base = nullptr;
+    this->mappedBytes = 0;
+    this->arr = nullptr;
+    this->count = 0;
+    this->capacity = 0;
+    this->highWater = 0;
+}
+
+template<typename T, typename GrowthPolicy>
+void MappedArrayStack<T, GrowthPolicy>::deepmove(MappedArrayStack &ms) {
+    // steal the file and the mapping
+    this->fd = ms.fd;
+    this->base = ms.base;
+    this->mappedBytes = ms.mappedBytes;
+    this->arr = ms.arr;
+    this->count = ms.count;
+    this->capacity = ms.capacity;
+    this->highWater = ms.highWater;
+
+    // reset ms to stable state
+    ms.fd = -1;
+    ms.base = nullptr;
+    ms.mappedBytes = 0;
+    ms.arr = nullptr;
+    ms.count = 0;
+    ms.capacity = 0;
+    ms.highWater = 0;
+}
+//////////////////////////////////////////////////////////////
+
+#endif //MAPPED_ARRAY_STACK_H
@@ -0,0 +1,88 @@
+#ifndef STATS_POLICY_H
+#define STATS_POLICY_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Instrumentation policies for the stack containers
+ *
+ * A container inherits its policy privately and reports every event to it.
+ * NoStats is empty and its hooks are empty inline functions, so a container
+ * without instrumentation has the same size and code as before. The counters
+ * are plain integers, a stack is not thread safe either.
+ */
+
+// what stats() returns, cheap to copy into a metrics exporter
+struct StackStats {
+    uint64_t pushes;
+    uint64_t pops;
+    // reallocations of the array, or new chunks for node based stacks
+    uint64_t growthEvents;
+    // bytes relocated by growth and shrink_to_fit
+    uint64_t bytesCopied;
+    size_t depth;
+    size_t peakDepth;
+    // bytes of element storage currently held
+    size_t footprintBytes;
+};
+
+// no instrumentation, every hook compiles to nothing
+struct NoStats {
+    static constexpr bool enabled = false;
+
+    void onPush(size_t, size_t) {
+    }
+
+    void onPop(size_t) {
+    }
+
+    void onGrow(size_t) {
+    }
+
+    void onRelocate(size_t) {
+    }
+
+    StackStats snapshot() const {
+        return StackStats {};
+    }
+};
+
+// count every event
+struct CountingStats {
+    static constexpr bool enabled = true;
+
+    // n elements pushed, depth after the push
+    void onPush(size_t n, size_t depth) {
+        pushes += n;
+        if (depth > peakDepth) {
+            peakDepth = depth;
+        }
+    }
+
+    void onPop(size_t n) {
+        pops += n;
+    }
+
+    void onGrow(size_t n) {
+        growthEvents += n;
+    }
+
+    void onRelocate(size_t bytes) {
+        bytesCopied += bytes;
+    }
+
+    // depth and footprint are filled in by the container
+    StackStats snapshot() const {
+        return StackStats {pushes, pops, growthEvents, bytesCopied, 0, peakDepth, 0};
+    }
+
+private:
+    uint64_t pushes {};
+    uint64_t pops {};
+    uint64_t growthEvents {};
+    uint64_t bytesCopied {};
+    size_t peakDepth {};
+};
+
+#endif //STATS_POLICY_H
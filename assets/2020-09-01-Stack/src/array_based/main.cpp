@@ -1,6 +1,14 @@
 #include <iostream>
 #include <assert.h>
+#include <string>
+#include <limits>
+#include <vector>
+#include <list>
+#include <sstream>
+#include <cstdio>
+#include <unistd.h>
 #include "ArrayStack.h"
+#include "MappedArrayStack.h"
 
 using std::cout;
 using std::endl;
@@ -64,8 +72,453 @@ void testIntStack() {
     assert(temp2.toString() == "");
 }
 
+// counts every constructor call so that hidden copies show up in the asserts
+struct Tracked {
+    static int defaultCtors;
+    static int copies;
+    static int moves;
+
+    int value;
+
+    Tracked() : value {0} { defaultCtors++; }
+    explicit Tracked(int v) : value {v} {}
+    Tracked(const Tracked &t) : value {t.value} { copies++; }
+    Tracked(Tracked &&t) noexcept : value {t.value} { moves++; }
+    Tracked& operator=(const Tracked &t) { value = t.value; copies++; return *this; }
+    Tracked& operator=(Tracked &&t) noexcept { value = t.value; moves++; return *this; }
+
+    static void reset() { defaultCtors = copies = moves = 0; }
+};
+
+int Tracked::defaultCtors = 0;
+int Tracked::copies = 0;
+int Tracked::moves = 0;
+
+void testConstructionCount() {
+    Tracked::reset();
+
+    // test constructor: no slot of the capacity is constructed
+    ArrayStack<Tracked> trackedStack{1000};
+    assert(Tracked::defaultCtors == 0);
+
+    // test emplace: constructed in place, neither copied nor moved
+    trackedStack.emplace(1);
+    assert(trackedStack.top().value == 1);
+    assert(Tracked::copies == 0 && Tracked::moves == 0);
+
+    // test push(T&&), pop: one move in, one move out, no copy
+    Tracked::reset();
+    for (int i = 0; i < 500; ++i) {
+        trackedStack.push(Tracked{i});
+        Tracked t = trackedStack.pop();
+        assert(t.value == i);
+    }
+    assert(Tracked::copies == 0);
+    assert(Tracked::moves == 2 * 500);
+    assert(Tracked::defaultCtors == 0);
+
+    // test push(const T&): exactly one copy
+    Tracked::reset();
+    Tracked lvalue{7};
+    trackedStack.push(lvalue);
+    assert(Tracked::copies == 1);
+    assert(trackedStack.size() == 2);
+}
+
+void testStringStack() {
+    // test heavy element type across growth
+    ArrayStack<string> strStack{1};
+    for (int i = 0; i < 100; ++i) {
+        strStack.push(string(32, static_cast<char>('a' + i % 26)));
+    }
+    assert(strStack.size() == 100);
+    assert(strStack.top() == string(32, static_cast<char>('a' + 99 % 26)));
+
+    // test emplace with constructor arguments
+    strStack.emplace(3, 'z');
+    assert(strStack.pop() == "zzz");
+
+    // test copy of non-trivial elements
+    ArrayStack<string> copied{strStack};
+    assert(copied.size() == 100);
+    assert(copied.pop() == strStack.top());
+
+    // test clear destroys the elements and the stack is reusable
+    strStack.clear();
+    assert(strStack.isEmpty() == true);
+    strStack.push("again");
+    assert(strStack.top() == "again");
+
+    // test push(top()) at capacity: the argument lives in the array the growth frees
+    ArrayStack<string> full{1};
+    full.push(string(40, 'x'));
+    full.push(full.top());
+    assert(full.size() == 2);
+    assert(full.pop() == string(40, 'x'));
+    assert(full.top() == string(40, 'x'));
+}
+
+void testGrowthPolicy() {
+    // test DoublingGrowth (default)
+    ArrayStack<int> doubling{4};
+    for (int i = 0; i < 5; ++i) {
+        doubling.push(i);
+    }
+    assert(doubling.getCapacity() == 8);
+
+    // test HalfGrowth
+    ArrayStack<int, HalfGrowth> half{4};
+    for (int i = 0; i < 7; ++i) {
+        half.push(i);
+    }
+    assert(half.getCapacity() == 9);
+    assert(half.toString() == "6\n5\n4\n3\n2\n1\n0\n");
+
+    // test ChunkGrowth
+    ArrayStack<int, ChunkGrowth<16>> chunk{0};
+    chunk.push(1);
+    assert(chunk.getCapacity() == 16);
+    for (int i = 0; i < 16; ++i) {
+        chunk.push(i);
+    }
+    assert(chunk.getCapacity() == 32);
+
+    // test reserve, shrink_to_fit
+    ArrayStack<string> strStack{1};
+    strStack.reserve(1000);
+    assert(strStack.getCapacity() == 1000);
+    for (int i = 0; i < 1000; ++i) {
+        strStack.push(std::to_string(i));
+    }
+    assert(strStack.getCapacity() == 1000);
+    for (int i = 0; i < 990; ++i) {
+        strStack.pop();
+    }
+    strStack.shrink_to_fit();
+    assert(strStack.getCapacity() == 10);
+    assert(strStack.top() == "9");
+    strStack.clear();
+    strStack.shrink_to_fit();
+    assert(strStack.getCapacity() == 0);
+    strStack.push("regrow");
+    assert(strStack.top() == "regrow");
+
+    // test relocation moves noexcept movable elements instead of copying them
+    Tracked::reset();
+    ArrayStack<Tracked> trackedStack{1};
+    for (int i = 0; i < 64; ++i) {
+        trackedStack.emplace(i);
+    }
+    assert(Tracked::copies == 0);
+    assert(trackedStack.top().value == 63);
+}
+
+void testBulkOperations() {
+    // test pushRange from a contiguous range (block copy) with a single growth
+    ArrayStack<int> intStack{2};
+    std::vector<int> values {1, 2, 3, 4, 5, 6, 7};
+    intStack.pushRange(values.data(), values.data() + values.size());
+    assert(intStack.size() == 7);
+    assert(intStack.getCapacity() == 8);
+    assert(intStack.toString() == "7\n6\n5\n4\n3\n2\n1\n");
+
+    // test pushRange from a non-contiguous range
+    std::list<int> more {8, 9};
+    intStack.pushRange(more.begin(), more.end());
+    assert(intStack.top() == 9);
+
+    // test popN, output in pop order
+    std::vector<int> out(4);
+    auto end = intStack.popN(4, out.begin());
+    assert(end == out.end());
+    assert((out == std::vector<int> {9, 8, 7, 6}));
+    assert(intStack.size() == 5);
+    assert(intStack.top() == 5);
+
+    // test popN with more than size
+    bool thrown = false;
+    try {
+        intStack.popN(6, out.begin());
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+    assert(intStack.size() == 5);
+
+    // test non-trivial elements, moved out by popN
+    ArrayStack<string> strStack{1};
+    std::vector<string> words {"a", "b", "c"};
+    strStack.pushRange(words.begin(), words.end());
+    std::vector<string> popped;
+    strStack.popN(3, std::back_inserter(popped));
+    assert((popped == std::vector<string> {"c", "b", "a"}));
+    assert(strStack.isEmpty() == true);
+
+    // test pushRange from the stack's own storage through a growth, block copy and element-wise
+    const int *bottom = &intStack.top() - (intStack.size() - 1);
+    intStack.pushRange(bottom, bottom + intStack.size());
+    assert(intStack.size() == 10);
+    assert(intStack.toString() == "5\n4\n3\n2\n1\n5\n4\n3\n2\n1\n");
+    for (const string &word : words) {
+        strStack.push(word + string(32, '!'));
+    }
+    const string *first = &strStack.top() - (strStack.size() - 1);
+    strStack.pushRange(first, first + strStack.size());
+    assert(strStack.size() == 6);
+    popped.clear();
+    strStack.popN(6, std::back_inserter(popped));
+    for (size_t i = 0; i < popped.size(); ++i) {
+        assert(popped[i] == words[2 - i % 3] + string(32, '!'));
+    }
+}
+
+void testFormatAndSnapshot() {
+    // test formatTo into a caller-provided buffer
+    ArrayStack<int> intStack{4};
+    intStack.push(-120);
+    intStack.push(0);
+    intStack.push(7);
+    intStack.push(2147483647);
+    assert(intStack.formattedSize() == intStack.toString().size());
+    char buf[64];
+    size_t n = intStack.formatTo(buf, sizeof(buf));
+    assert(string(buf, n) == "2147483647\n7\n0\n-120\n");
+
+    // test formatTo with a buffer that is too small
+    bool thrown = false;
+    try {
+        intStack.formatTo(buf, 5);
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+
+    // test formatTo into a stream
+    std::ostringstream oss;
+    intStack.formatTo(oss);
+    assert(oss.str() == intStack.toString());
+
+    // test floating point keeps the std::to_string text
+    ArrayStack<double> doubleStack{2};
+    doubleStack.push(1.5);
+    doubleStack.push(-0.25);
+    assert(doubleStack.toString() == std::to_string(-0.25) + "\n" + std::to_string(1.5) + "\n");
+    assert(doubleStack.formattedSize() == doubleStack.toString().size());
+
+    // test the extremes, long double needs thousands of digits in fixed notation
+    ArrayStack<long double> longDoubleStack{1};
+    longDoubleStack.push(std::numeric_limits<long double>::max());
+    longDoubleStack.push(-std::numeric_limits<long double>::max());
+    string longDoubles = longDoubleStack.toString();
+    assert(longDoubles.size() == longDoubleStack.formattedSize());
+    assert(longDoubles.size() > 2 * 4900);
+    std::ostringstream longDoubleStream;
+    longDoubleStack.formatTo(longDoubleStream);
+    assert(longDoubleStream.str() == longDoubles);
+    ArrayStack<double> maxDoubleStack{1};
+    maxDoubleStack.push(-std::numeric_limits<double>::max());
+    assert(maxDoubleStack.toString() == std::to_string(-std::numeric_limits<double>::max()) + "\n");
+
+    // test saveBinary, loadBinary round trip
+    ArrayStack<long> longStack{1};
+    for (long i = 0; i < 1000; ++i) {
+        longStack.push(i * i);
+    }
+    std::stringstream checkpoint;
+    longStack.saveBinary(checkpoint);
+    ArrayStack<long> restored{1};
+    restored.push(-1);
+    restored.loadBinary(checkpoint);
+    assert(restored.size() == 1000);
+    assert(restored.toString() == longStack.toString());
+
+    // test loadBinary rejects a checkpoint of another element type
+    std::stringstream intCheckpoint;
+    intStack.saveBinary(intCheckpoint);
+    thrown = false;
+    try {
+        restored.loadBinary(intCheckpoint);
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+    assert(restored.size() == 1000);
+}
+
+void testMappedStack() {
+    struct Frame {
+        long depth;
+        long choice[7];
+    };
+    string path = "/tmp/mappedStack." + std::to_string(::getpid());
+
+    // test push, growth through the mapping, top
+    {
+        MappedArrayStack<Frame> ms{path, 1, false};
+        assert(ms.isEmpty() == true);
+        size_t initial = ms.getCapacity();
+        for (long i = 0; i < 100000; ++i) {
+            ms.push(Frame {i, {i, i + 1}});
+        }
+        assert(ms.size() == 100000);
+        assert(ms.getCapacity() > initial);
+        assert(ms.top().depth == 99999);
+
+        // test pop, popped pages are dropped on the way down
+        for (long i = 99999; i >= 50000; --i) {
+            Frame f = ms.pop();
+            assert(f.depth == i && f.choice[1] == i + 1);
+        }
+        ms.sync();
+    }
+
+    // test reopen after a restart
+    {
+        MappedArrayStack<Frame> ms{path};
+        assert(ms.size() == 50000);
+        assert(ms.top().depth == 49999);
+        ms.push(Frame {-1, {}});
+        for (long i = 50000; i >= 0; --i) {
+            assert(ms.pop().depth == (i == 50000 ? -1 : i));
+        }
+        assert(ms.isEmpty() == true);
+
+        // test push(top()) through every growth: the argument lives in the mapping the remap moves
+        ms.push(Frame {7, {8}});
+        for (long i = 0; i < 100000; ++i) {
+            ms.push(ms.top());
+        }
+        assert(ms.size() == 100001);
+        while (!ms.isEmpty()) {
+            Frame f = ms.pop();
+            assert(f.depth == 7 && f.choice[0] == 8);
+        }
+
+        // test pop on an empty stack
+        bool thrown = false;
+        try {
+            ms.pop();
+        } catch (const std::runtime_error &e) {
+            thrown = true;
+        }
+        assert(thrown == true);
+
+        for (long i = 0; i < 10; ++i) {
+            ms.push(Frame {i, {i}});
+        }
+    }
+
+    // test reopen as another element type: rejected, and the file is left as it was
+    bool thrown = false;
+    try {
+        MappedArrayStack<int> ms{path};
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+    {
+        MappedArrayStack<Frame> ms{path};
+        assert(ms.size() == 10);
+        for (long i = 9; i >= 0; --i) {
+            Frame f = ms.pop();
+            assert(f.depth == i && f.choice[0] == i);
+        }
+    }
+
+    // test move, toString
+    {
+        MappedArrayStack<int> ms{path, 4, false};
+        ms.push(1);
+        ms.push(2);
+        MappedArrayStack<int> moved {std::move(ms)};
+        assert(moved.toString() == "2\n1\n");
+        moved.clear();
+        assert(moved.isEmpty() == true);
+    }
+    std::remove(path.c_str());
+}
+
+void testStats() {
+    // test that NoStats adds nothing: vptr, arr, count, capacity
+    static_assert(sizeof(ArrayStack<int>) == 4 * sizeof(void *), "NoStats must not add state");
+
+    ArrayStack<int, DoublingGrowth, CountingStats> intStack{2};
+    for (int i = 0; i < 10; ++i) {
+        intStack.push(i);
+    }
+    int input[] = {10, 11, 12};
+    intStack.pushRange(input, input + 3);
+    intStack.pop();
+    std::vector<int> out;
+    intStack.popN(5, std::back_inserter(out));
+
+    // growths 2 -> 4 -> 8 -> 16, relocating 2 + 4 + 8 ints
+    StackStats st = intStack.stats();
+    assert(st.pushes == 13);
+    assert(st.pops == 6);
+    assert(st.growthEvents == 3);
+    assert(st.bytesCopied == 14 * sizeof(int));
+    assert(st.depth == 7);
+    assert(st.peakDepth == 13);
+    assert(st.footprintBytes == 16 * sizeof(int));
+
+    // test shrink_to_fit relocates without counting as growth
+    intStack.shrink_to_fit();
+    st = intStack.stats();
+    assert(st.growthEvents == 3);
+    assert(st.bytesCopied == 21 * sizeof(int));
+    assert(st.footprintBytes == 7 * sizeof(int));
+
+    // test that a copy reports its elements as pushes, the storage is sized up front
+    ArrayStack<int, DoublingGrowth, CountingStats> copied {intStack};
+    st = copied.stats();
+    assert(st.pushes == 7);
+    assert(st.peakDepth == 7);
+    assert(st.growthEvents == 0);
+
+    // test that loadBinary reports the loaded elements and the growth that made room for them
+    std::stringstream checkpoint;
+    intStack.saveBinary(checkpoint);
+    ArrayStack<int, DoublingGrowth, CountingStats> loaded{1};
+    loaded.loadBinary(checkpoint);
+    st = loaded.stats();
+    assert(st.pushes == 7);
+    assert(st.peakDepth == 7);
+    assert(st.growthEvents == 1);
+
+    // test that a disabled policy still reports depth and footprint
+    ArrayStack<int> plain{4};
+    plain.push(1);
+    st = plain.stats();
+    assert(st.pushes == 0 && st.depth == 1 && st.footprintBytes == 4 * sizeof(int));
+}
+
+void testTryOperations() {
+    ArrayStack<std::string> s{1};
+    // test tryPop, tryTop on an empty stack: no exception
+    assert(!s.tryPop());
+    assert(!s.tryTop());
+    static_assert(noexcept(s.tryPop()), "tryPop of a nothrow movable T must be noexcept");
+
+    s.push("a");
+    s.push("b");
+    assert(*s.tryTop() == "b");
+    assert(s.tryPop().value() == "b");
+    assert(s.tryPop().value() == "a");
+    assert(!s.tryPop());
+    assert(s.isEmpty() == true);
+}
+
 int main() {
     testIntStack();
+    testConstructionCount();
+    testStringStack();
+    testGrowthPolicy();
+    testBulkOperations();
+    testFormatAndSnapshot();
+    testMappedStack();
+    testStats();
+    testTryOperations();
 
     return 0;
 }
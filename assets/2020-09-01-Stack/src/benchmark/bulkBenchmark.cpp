@@ -0,0 +1,68 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include "../array_based/ArrayStack.h"
+#include "../linked_list_based/LinkedListStack.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::string;
+
+// push a burst of frames and pop it again, element-wise or batched
+// returns nanoseconds per element
+template<typename Stack, typename T, bool BATCHED>
+double runBursts(const vector<T> &burst, int rounds) {
+    Stack stack;
+    vector<T> out(burst.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        if constexpr (BATCHED) {
+            stack.pushRange(burst.begin(), burst.end());
+            stack.popN(burst.size(), out.begin());
+        } else {
+            for (const T &e : burst) {
+                stack.push(e);
+            }
+            for (size_t i = 0; i < burst.size(); ++i) {
+                out[i] = stack.pop();
+            }
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / (static_cast<double>(rounds) * burst.size());
+}
+
+template<typename Stack, typename T>
+void report(const string &name, const vector<T> &burst, int rounds) {
+    double elementWise = runBursts<Stack, T, false>(burst, rounds);
+    double batched = runBursts<Stack, T, true>(burst, rounds);
+    cout << name << "," << burst.size() << "," << std::fixed << std::setprecision(2)
+         << elementWise << "," << batched << endl;
+}
+
+int main(int argc, char **argv) {
+    int rounds = argc > 1 ? std::stoi(argv[1]) : 20000;
+
+    cout << "stack,burst,element_wise_ns_per_elem,batched_ns_per_elem" << endl;
+    for (size_t burstSize : {16, 256, 4096}) {
+        vector<int> ints(burstSize);
+        for (size_t i = 0; i < burstSize; ++i) {
+            ints[i] = static_cast<int>(i);
+        }
+        vector<string> strings(burstSize, string(32, 's'));
+
+        int scaledRounds = std::max(1, static_cast<int>(rounds * 256 / burstSize));
+        report<ArrayStack<int>>("ArrayStack<int>", ints, scaledRounds);
+        report<ArrayStack<string>>("ArrayStack<string>", strings, scaledRounds);
+        report<LinkedListStack<int>>("LinkedListStack<int>", ints, scaledRounds);
+        report<LinkedListStack<string>>("LinkedListStack<string>", strings, scaledRounds);
+    }
+
+    return 0;
+}
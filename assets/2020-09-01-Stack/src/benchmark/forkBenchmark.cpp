@@ -0,0 +1,93 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include "../array_based/ArrayStack.h"
+#include "../linked_list_based/LinkedListStack.h"
+#include "../persistent_based/PersistentStack.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::string;
+
+// speculative parsing: fork the parser stack, try a few reductions
+// (push SPECULATE, pop half of them), then throw the fork away
+static const int SPECULATE = 8;
+
+static volatile int64_t checksumSink = 0;
+
+// mutable stacks: a fork is a deep copy
+// returns nanoseconds per fork
+template<typename Stack>
+double runDeepCopy(size_t depth, int forks) {
+    Stack base;
+    for (size_t i = 0; i < depth; ++i) {
+        base.push(static_cast<int>(i));
+    }
+
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < forks; ++f) {
+        Stack fork {base};
+        for (int i = 0; i < SPECULATE; ++i) {
+            fork.push(f + i);
+        }
+        for (int i = 0; i < SPECULATE / 2; ++i) {
+            checksum += fork.pop();
+        }
+        checksum += fork.top();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    checksumSink = checksum;
+    return elapsed.count() / forks;
+}
+
+// persistent stack: a fork is a new version sharing the base
+template<typename Stack>
+double runShared(size_t depth, int forks) {
+    Stack base;
+    for (size_t i = 0; i < depth; ++i) {
+        base = base.push(static_cast<int>(i));
+    }
+
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < forks; ++f) {
+        Stack fork {base};
+        for (int i = 0; i < SPECULATE; ++i) {
+            fork = fork.push(f + i);
+        }
+        for (int i = 0; i < SPECULATE / 2; ++i) {
+            checksum += fork.top();
+            fork = fork.pop();
+        }
+        checksum += fork.top();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    checksumSink = checksum;
+    return elapsed.count() / forks;
+}
+
+int main(int argc, char **argv) {
+    int forks = argc > 1 ? std::stoi(argv[1]) : 20000;
+
+    cout << "stack,depth,ns_per_fork" << endl;
+    for (size_t depth : {16, 256, 4096, 65536}) {
+        // fewer forks for the deep stacks, the deep copies dominate
+        int scaledForks = std::max(1, static_cast<int>(forks * 256 / std::max<size_t>(depth, 256)));
+        cout << std::fixed << std::setprecision(2);
+        cout << "ArrayStack," << depth << "," << runDeepCopy<ArrayStack<int>>(depth, scaledForks) << endl;
+        cout << "LinkedListStack," << depth << "," << runDeepCopy<LinkedListStack<int>>(depth, scaledForks) << endl;
+        cout << "PersistentStack," << depth << "," << runShared<PersistentStack<int>>(depth, scaledForks) << endl;
+        cout << "PersistentStack<atomic>," << depth << ","
+             << runShared<PersistentStack<int, true>>(depth, scaledForks) << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include "../array_based/ArrayStack.h"
+#include "../linked_list_based/LinkedListStack.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::string;
+
+static volatile int64_t checksumSink = 0;
+
+// a consumer polling a mostly empty stack: a push happens on hitPercent of
+// the iterations, a pop is attempted on every iteration
+// returns nanoseconds per pop attempt
+template<typename Stack, bool THROWING>
+double runPolls(int iterations, int hitPercent) {
+    Stack stack;
+    int64_t checksum = 0;
+    uint64_t lcg = 42;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+        if (static_cast<int>((lcg >> 33) % 100) < hitPercent) {
+            stack.push(i);
+        }
+        if constexpr (THROWING) {
+            try {
+                checksum += stack.pop();
+            } catch (const std::runtime_error &e) {
+                checksum--;
+            }
+        } else {
+            std::optional<int> e = stack.tryPop();
+            checksum += e ? *e : -1;
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    checksumSink = checksum;
+    return elapsed.count() / iterations;
+}
+
+template<typename Stack>
+void report(const string &name, int iterations, int hitPercent) {
+    double throwing = runPolls<Stack, true>(iterations, hitPercent);
+    double trying = runPolls<Stack, false>(iterations, hitPercent);
+    cout << name << "," << 100 - hitPercent << "," << std::fixed << std::setprecision(2)
+         << throwing << "," << trying << endl;
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? std::stoi(argv[1]) : 1000000;
+
+    cout << "stack,miss_percent,throwing_pop_ns,try_pop_ns" << endl;
+    for (int hitPercent : {100, 90, 50, 10, 1}) {
+        report<ArrayStack<int>>("ArrayStack", iterations, hitPercent);
+        report<LinkedListStack<int>>("LinkedListStack", iterations, hitPercent);
+    }
+
+    return 0;
+}
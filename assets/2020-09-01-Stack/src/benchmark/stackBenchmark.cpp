@@ -0,0 +1,347 @@
+/**
+ * Stack benchmark suite
+ *
+ * Compares ArrayStack, LinkedListStack, SegmentedStack, std::stack<vector> and std::stack<deque>
+ * with int, a 64-byte POD and std::string elements under three patterns:
+ *   push_drain   push N elements, then pop all of them
+ *   interleaved  pre-fill 1024 elements, then N / 2 times push + pop
+ *   bursty       bursts of 1..1024 pushes followed by as many pops
+ *
+ * One CSV line per case on stdout:
+ *   container,element,pattern,ops,ns_per_op,allocations,peak_rss_kb,cache_misses
+ * allocations counts malloc/calloc/realloc calls (glibc only, -1 elsewhere),
+ * peak_rss_kb is reset before every case where /proc/self/clear_refs allows it,
+ * cache_misses comes from perf_event_open and is -1 when it is not permitted.
+ *
+ * build: g++ -std=c++17 -O2 stackBenchmark.cpp -o stackBenchmark
+ * run:   ./stackBenchmark [N = 1000000]
+ */
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <deque>
+#include <stack>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include "../array_based/ArrayStack.h"
+#include "../linked_list_based/LinkedListStack.h"
+#include "../segmented_based/SegmentedStack.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+/////////////////////////  Allocation Counting  /////////////////////////
+static std::atomic<long> allocationCount {0};
+
+#ifdef __GLIBC__
+// interpose the allocator, operator new ends up here as well
+extern "C" {
+void *__libc_malloc(size_t);
+void *__libc_calloc(size_t, size_t);
+void *__libc_realloc(void *, size_t);
+void __libc_free(void *);
+
+void *malloc(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *p, size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, size);
+}
+
+void free(void *p) {
+    __libc_free(p);
+}
+}
+static const bool countsAllocations = true;
+#else
+static const bool countsAllocations = false;
+#endif
+
+/////////////////////////  Peak RSS  /////////////////////////
+// reset the high water mark of the resident set (Linux >= 4.0)
+void resetPeakRss() {
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs) {
+        clearRefs << "5";
+    }
+}
+
+long peakRssKb() {
+    std::ifstream status("/proc/self/status");
+    string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+    return -1;
+}
+
+/////////////////////////  Cache Misses  /////////////////////////
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr {};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd >= 0) {
+            close(fd);
+        }
+#endif
+    }
+
+    CacheMissCounter(const CacheMissCounter &) = delete;
+
+    CacheMissCounter& operator=(const CacheMissCounter &) = delete;
+
+    void start() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // -1 if the counter is not available
+    long long stop() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            long long value = 0;
+            if (read(fd, &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value))) {
+                return value;
+            }
+        }
+#endif
+        return -1;
+    }
+
+private:
+    int fd {-1};
+};
+
+/////////////////////////  Element Types  /////////////////////////
+struct Pod64 {
+    uint64_t words[8];
+};
+
+template<typename T>
+T makeElement(size_t i);
+
+template<>
+int makeElement<int>(size_t i) {
+    return static_cast<int>(i);
+}
+
+template<>
+Pod64 makeElement<Pod64>(size_t i) {
+    Pod64 p {};
+    p.words[0] = i;
+    return p;
+}
+
+template<>
+string makeElement<string>(size_t i) {
+    // longer than the small string buffer, so every element owns heap memory
+    string s(32, 's');
+    s[0] = static_cast<char>('a' + i % 26);
+    return s;
+}
+
+// fold a popped element into a checksum so that the work cannot be optimized away
+inline uint64_t fold(int e) {
+    return static_cast<uint64_t>(e);
+}
+
+inline uint64_t fold(const Pod64 &e) {
+    return e.words[0];
+}
+
+inline uint64_t fold(const string &e) {
+    return static_cast<uint64_t>(e[0]);
+}
+
+/////////////////////////  Containers  /////////////////////////
+// gives std::stack the pop-returns-value interface of the repo stacks
+template<typename T, typename Container>
+class StdStack {
+public:
+    void push(T e) {
+        stack.push(std::move(e));
+    }
+
+    T pop() {
+        T ret {std::move(stack.top())};
+        stack.pop();
+        return ret;
+    }
+
+private:
+    std::stack<T, Container> stack;
+};
+
+/////////////////////////  Patterns  /////////////////////////
+// every pattern returns the number of push + pop operations
+template<typename Stack, typename T>
+size_t pushDrain(Stack &stack, const vector<T> &input, uint64_t &checksum) {
+    for (const T &e : input) {
+        stack.push(e);
+    }
+    for (size_t i = 0; i < input.size(); ++i) {
+        checksum += fold(stack.pop());
+    }
+    return 2 * input.size();
+}
+
+template<typename Stack, typename T>
+size_t interleaved(Stack &stack, const vector<T> &input, uint64_t &checksum) {
+    size_t base = std::min<size_t>(1024, input.size());
+    for (size_t i = 0; i < base; ++i) {
+        stack.push(input[i]);
+    }
+    for (size_t i = 0; i < input.size() / 2; ++i) {
+        stack.push(input[i]);
+        checksum += fold(stack.pop());
+    }
+    for (size_t i = 0; i < base; ++i) {
+        checksum += fold(stack.pop());
+    }
+    return 2 * base + 2 * (input.size() / 2);
+}
+
+template<typename Stack, typename T>
+size_t bursty(Stack &stack, const vector<T> &input, uint64_t &checksum) {
+    // deterministic burst sizes, the same for every container
+    uint64_t lcg = 42;
+    size_t done = 0;
+    while (done < input.size()) {
+        lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+        size_t burst = std::min<size_t>(1 + (lcg >> 33) % 1024, input.size() - done);
+        for (size_t i = 0; i < burst; ++i) {
+            stack.push(input[done + i]);
+        }
+        for (size_t i = 0; i < burst; ++i) {
+            checksum += fold(stack.pop());
+        }
+        done += burst;
+    }
+    return 2 * input.size();
+}
+
+/////////////////////////  Driver  /////////////////////////
+static volatile uint64_t checksumSink = 0;
+
+enum class Pattern { PUSH_DRAIN, INTERLEAVED, BURSTY };
+
+const char* patternName(Pattern p) {
+    switch (p) {
+        case Pattern::PUSH_DRAIN:
+            return "push_drain";
+        case Pattern::INTERLEAVED:
+            return "interleaved";
+        default:
+            return "bursty";
+    }
+}
+
+template<typename Stack, typename T>
+void runCase(const string &container, const string &element, Pattern pattern,
+             const vector<T> &input, CacheMissCounter &cacheMisses) {
+    uint64_t checksum = 0;
+    resetPeakRss();
+    long allocationsBefore = allocationCount.load();
+    cacheMisses.start();
+    auto start = std::chrono::steady_clock::now();
+
+    size_t ops = 0;
+    {
+        // construction and destruction are part of the measurement
+        Stack stack;
+        switch (pattern) {
+            case Pattern::PUSH_DRAIN:
+                ops = pushDrain(stack, input, checksum);
+                break;
+            case Pattern::INTERLEAVED:
+                ops = interleaved(stack, input, checksum);
+                break;
+            case Pattern::BURSTY:
+                ops = bursty(stack, input, checksum);
+                break;
+        }
+    }
+
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    long long misses = cacheMisses.stop();
+    long allocations = countsAllocations ? allocationCount.load() - allocationsBefore : -1;
+
+    cout << container << "," << element << "," << patternName(pattern) << "," << ops << ","
+         << std::fixed << std::setprecision(3) << elapsed.count() / static_cast<double>(ops) << ","
+         << allocations << "," << peakRssKb() << "," << misses << endl;
+
+    // keep the checksum observable
+    checksumSink = checksum;
+}
+
+template<typename T>
+void runElement(const string &element, size_t n, CacheMissCounter &cacheMisses) {
+    vector<T> input;
+    input.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        input.push_back(makeElement<T>(i));
+    }
+
+    for (Pattern pattern : {Pattern::PUSH_DRAIN, Pattern::INTERLEAVED, Pattern::BURSTY}) {
+        runCase<ArrayStack<T>>("ArrayStack", element, pattern, input, cacheMisses);
+        runCase<LinkedListStack<T>>("LinkedListStack", element, pattern, input, cacheMisses);
+        runCase<SegmentedStack<T>>("SegmentedStack", element, pattern, input, cacheMisses);
+        runCase<StdStack<T, std::vector<T>>>("std::stack<vector>", element, pattern, input, cacheMisses);
+        runCase<StdStack<T, std::deque<T>>>("std::stack<deque>", element, pattern, input, cacheMisses);
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    CacheMissCounter cacheMisses;
+    cout << "container,element,pattern,ops,ns_per_op,allocations,peak_rss_kb,cache_misses" << endl;
+    runElement<int>("int", n, cacheMisses);
+    runElement<Pod64>("pod64", n, cacheMisses);
+    runElement<string>("string", n, cacheMisses);
+
+    return 0;
+}
@@ -0,0 +1,291 @@
+#ifndef BLOCKING_ARRAY_STACK_H
+#define BLOCKING_ARRAY_STACK_H
+
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <optional>
+#include <stdexcept>
+#include <condition_variable>
+#include "../array_based/ArrayStack.h"
+
+using std::atomic;
+
+/**
+ * Bounded blocking array based Stack for producer/consumer pipelines
+ *
+ * The elements live in an ArrayStack that never grows: push() waits while
+ * the stack is full and pop() waits while it is empty, so a fast producer is
+ * held back instead of growing memory without bound.
+ *
+ * A waiting thread first spins for a short while on a lock-free copy of the
+ * element count, which catches the common case of the other side catching up
+ * within microseconds, and only then parks on a condition variable. Notifies
+ * are skipped when nobody is parked, so an uncontended pipeline makes no
+ * futex calls.
+ *
+ * close() wakes every waiter: pushes fail from then on, pops drain what is
+ * left and then fail.
+ *
+ * @tparam T  generic type, expected to be move constructible
+ */
+template<typename T>
+class BlockingArrayStack {
+public:
+    // constructor, capacity is the bound
+    explicit BlockingArrayStack(size_t capacity = 100);
+
+    /////////////////////////  Big Five  /////////////////////////
+    // 1. destructor
+    virtual ~BlockingArrayStack() = default;
+
+    // 2. / 3. copy, 4. / 5. move: a shared stack is identified by its address
+    BlockingArrayStack(const BlockingArrayStack &) = delete;
+
+    BlockingArrayStack& operator=(const BlockingArrayStack &) = delete;
+
+    BlockingArrayStack(BlockingArrayStack &&) = delete;
+
+    BlockingArrayStack& operator=(BlockingArrayStack &&) = delete;
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Principle Operations  ///////////////////
+    // waits while the stack is full, throws once the stack is closed
+    void push(T e);
+
+    // waits while the stack is empty, throws once the stack is closed and drained
+    T pop();
+
+    // false if the stack stayed full for timeout or is closed, e is only moved from on success
+    template<typename Rep, typename Period>
+    bool tryPush(T &&e, const std::chrono::duration<Rep, Period> &timeout);
+
+    template<typename Rep, typename Period>
+    bool tryPush(const T &e, const std::chrono::duration<Rep, Period> &timeout);
+
+    // std::nullopt if the stack stayed empty for timeout or is closed and drained
+    template<typename Rep, typename Period>
+    std::optional<T> tryPop(const std::chrono::duration<Rep, Period> &timeout);
+
+    // wake every waiter and refuse further pushes
+    void close();
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Auxiliary Operations  ///////////////////
+    // the results below are snapshots, they may be stale once returned
+    bool isEmpty() const;
+
+    bool isFull() const;
+
+    size_t size() const;
+
+    size_t getCapacity() const;
+
+    bool isClosed() const;
+    //////////////////////////////////////////////////////////////
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // polls of count before parking
+    static constexpr int SPIN_LIMIT = 100;
+
+    ArrayStack<T> stack;
+
+    const size_t capacity;
+
+    // copy of stack.size() for spinning and the snapshots, written under lock
+    alignas(64) atomic<size_t> count {0};
+
+    atomic<bool> closed {false};
+
+    mutable std::mutex lock;
+
+    std::condition_variable notFull;
+
+    std::condition_variable notEmpty;
+
+    // parked threads, guarded by lock
+    size_t pushWaiters {};
+
+    size_t popWaiters {};
+
+    ///////////////////  Auxiliary Functions  ////////////////////
+    // spin until ready() or SPIN_LIMIT polls, without the lock
+    template<typename Ready>
+    static void spin(Ready ready);
+
+    // deadline nullptr waits forever; returns false on timeout or close
+    template<typename U>
+    bool pushUntil(U &&e, const Clock::time_point *deadline);
+
+    std::optional<T> popUntil(const Clock::time_point *deadline);
+    //////////////////////////////////////////////////////////////
+};
+
+///////////////////  Function Implementation  ///////////////////
+// constructor
+template<typename T>
+BlockingArrayStack<T>::BlockingArrayStack(size_t capacity) : stack {capacity}, capacity {capacity} {
+    if (capacity == 0) {
+        throw std::invalid_argument("BlockingArrayStack needs a positive capacity.");
+    }
+}
+
+///////////////////  Principle Operations  ///////////////////
+template<typename T>
+void BlockingArrayStack<T>::push(T e) {
+    if (!pushUntil(std::move(e), nullptr)) {
+        throw std::runtime_error("Stack is closed.");
+    }
+}
+
+template<typename T>
+T BlockingArrayStack<T>::pop() {
+    std::optional<T> ret = popUntil(nullptr);
+    if (!ret) {
+        throw std::runtime_error("Stack is closed.");
+    }
+    return std::move(*ret);
+}
+
+template<typename T>
+template<typename Rep, typename Period>
+bool BlockingArrayStack<T>::tryPush(T &&e, const std::chrono::duration<Rep, Period> &timeout) {
+    Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout);
+    return pushUntil(std::move(e), &deadline);
+}
+
+template<typename T>
+template<typename Rep, typename Period>
+bool BlockingArrayStack<T>::tryPush(const T &e, const std::chrono::duration<Rep, Period> &timeout) {
+    Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout);
+    return pushUntil(e, &deadline);
+}
+
+template<typename T>
+template<typename Rep, typename Period>
+std::optional<T> BlockingArrayStack<T>::tryPop(const std::chrono::duration<Rep, Period> &timeout) {
+    Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout);
+    return popUntil(&deadline);
+}
+
+template<typename T>
+void BlockingArrayStack<T>::close() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        closed.store(true, std::memory_order_relaxed);
+    }
+    notFull.notify_all();
+    notEmpty.notify_all();
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Operations  ///////////////////
+template<typename T>
+bool BlockingArrayStack<T>::isEmpty() const {
+    return size() == 0;
+}
+
+template<typename T>
+bool BlockingArrayStack<T>::isFull() const {
+    return size() == capacity;
+}
+
+template<typename T>
+size_t BlockingArrayStack<T>::size() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+template<typename T>
+size_t BlockingArrayStack<T>::getCapacity() const {
+    return capacity;
+}
+
+template<typename T>
+bool BlockingArrayStack<T>::isClosed() const {
+    return closed.load(std::memory_order_relaxed);
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Functions  ////////////////////
+template<typename T>
+template<typename Ready>
+void BlockingArrayStack<T>::spin(Ready ready) {
+    for (int i = 0; i < SPIN_LIMIT && !ready(); ++i) {
+        std::this_thread::yield();
+    }
+}
+
+template<typename T>
+template<typename U>
+bool BlockingArrayStack<T>::pushUntil(U &&e, const Clock::time_point *deadline) {
+    spin([this]() { return count.load(std::memory_order_relaxed) < capacity || closed.load(std::memory_order_relaxed); });
+
+    std::unique_lock<std::mutex> guard(lock);
+    while (stack.size() == capacity && !closed.load(std::memory_order_relaxed)) {
+        // park
+        pushWaiters++;
+        if (deadline == nullptr) {
+            notFull.wait(guard);
+        } else if (notFull.wait_until(guard, *deadline) == std::cv_status::timeout) {
+            pushWaiters--;
+            // the last chance, room may have been made right at the deadline
+            if (stack.size() == capacity || closed.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            break;
+        }
+        pushWaiters--;
+    }
+    if (closed.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    stack.push(std::forward<U>(e));
+    count.store(stack.size(), std::memory_order_relaxed);
+    bool wake = popWaiters > 0;
+    guard.unlock();
+    if (wake) {
+        notEmpty.notify_one();
+    }
+    return true;
+}
+
+template<typename T>
+std::optional<T> BlockingArrayStack<T>::popUntil(const Clock::time_point *deadline) {
+    spin([this]() { return count.load(std::memory_order_relaxed) > 0 || closed.load(std::memory_order_relaxed); });
+
+    std::unique_lock<std::mutex> guard(lock);
+    while (stack.isEmpty() && !closed.load(std::memory_order_relaxed)) {
+        // park
+        popWaiters++;
+        if (deadline == nullptr) {
+            notEmpty.wait(guard);
+        } else if (notEmpty.wait_until(guard, *deadline) == std::cv_status::timeout) {
+            popWaiters--;
+            if (stack.isEmpty()) {
+                return std::nullopt;
+            }
+            break;
+        }
+        popWaiters--;
+    }
+    // a closed stack is still drained
+    if (stack.isEmpty()) {
+        return std::nullopt;
+    }
+
+    std::optional<T> ret {stack.pop()};
+    count.store(stack.size(), std::memory_order_relaxed);
+    bool wake = pushWaiters > 0;
+    guard.unlock();
+    if (wake) {
+        notFull.notify_one();
+    }
+    return ret;
+}
+//////////////////////////////////////////////////////////////
+
+#endif //BLOCKING_ARRAY_STACK_H
@@ -0,0 +1,190 @@
+#ifndef CONCURRENT_ARRAY_STACK_H
+#define CONCURRENT_ARRAY_STACK_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <optional>
+#include <stdexcept>
+#include "EliminationArray.h"
+#include "../array_based/ArrayStack.h"
+
+using std::atomic;
+
+/**
+ * Concurrent array based Stack with elimination backoff
+ *
+ * The elements live in an ArrayStack (contiguous buffer, same capacity and
+ * growth semantics, isFull() included) guarded by a test-and-test-and-set
+ * lock. A thread that finds the lock taken does not queue on it, it visits
+ * the EliminationArray first, where a concurrent push and pop can meet and
+ * cancel out. Only when that fails does it retry the shared stack, so under
+ * balanced MPMC load most operations never touch the shared top.
+ *
+ * @tparam T  generic type, expected to be move constructible and copy constructible
+ */
+template<typename T>
+class ConcurrentArrayStack {
+public:
+    // constructor
+    explicit ConcurrentArrayStack(size_t size = 100, size_t eliminationSlots = 8);
+
+    /////////////////////////  Big Five  /////////////////////////
+    // 1. destructor
+    virtual ~ConcurrentArrayStack() = default;
+
+    // 2. / 3. copy, 4. / 5. move: a shared stack is identified by its address
+    ConcurrentArrayStack(const ConcurrentArrayStack &) = delete;
+
+    ConcurrentArrayStack& operator=(const ConcurrentArrayStack &) = delete;
+
+    ConcurrentArrayStack(ConcurrentArrayStack &&) = delete;
+
+    ConcurrentArrayStack& operator=(ConcurrentArrayStack &&) = delete;
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Principle Operations  ///////////////////
+    void push(T e);
+
+    T pop();
+
+    // pop that reports an empty stack with std::nullopt instead of throwing
+    std::optional<T> tryPop();
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Auxiliary Operations  ///////////////////
+    // the results below are snapshots, they may be stale once returned
+    bool isEmpty();
+
+    bool isFull();
+
+    size_t size();
+
+    T top();
+    //////////////////////////////////////////////////////////////
+
+private:
+    // test-and-test-and-set lock, Lockable so std::unique_lock / std::lock_guard release it
+    // on every path, exceptions from T included
+    class SpinLock {
+    public:
+        bool try_lock();
+
+        void lock();
+
+        void unlock();
+
+    private:
+        atomic<bool> locked {false};
+    };
+
+    ArrayStack<T> stack;
+
+    EliminationArray<T> elimination;
+
+    // the lock gets its own cache line, it is the contended word
+    alignas(64) SpinLock spinLock;
+};
+
+///////////////////  Function Implementation  ///////////////////
+// constructor
+template<typename T>
+ConcurrentArrayStack<T>::ConcurrentArrayStack(size_t size, size_t eliminationSlots)
+        : stack {size}, elimination {eliminationSlots} {
+}
+
+///////////////////  Principle Operations  ///////////////////
+template<typename T>
+void ConcurrentArrayStack<T>::push(T e) {
+    while (true) {
+        std::unique_lock<SpinLock> guard(spinLock, std::try_to_lock);
+        if (guard.owns_lock()) {
+            stack.push(std::move(e));
+            return;
+        }
+        // contended, try to meet a pop instead
+        if (elimination.tryPush(e)) {
+            return;
+        }
+    }
+}
+
+template<typename T>
+T ConcurrentArrayStack<T>::pop() {
+    std::optional<T> ret = tryPop();
+    if (!ret) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return std::move(*ret);
+}
+
+template<typename T>
+std::optional<T> ConcurrentArrayStack<T>::tryPop() {
+    while (true) {
+        std::unique_lock<SpinLock> guard(spinLock, std::try_to_lock);
+        if (guard.owns_lock()) {
+            std::optional<T> ret;
+            if (!stack.isEmpty()) {
+                ret.emplace(stack.pop());
+            }
+            return ret;
+        }
+        // contended, try to meet a push instead
+        std::optional<T> ret = elimination.tryPop();
+        if (ret) {
+            return ret;
+        }
+    }
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Operations  ///////////////////
+template<typename T>
+bool ConcurrentArrayStack<T>::isEmpty() {
+    std::lock_guard<SpinLock> guard(spinLock);
+    return stack.isEmpty();
+}
+
+template<typename T>
+bool ConcurrentArrayStack<T>::isFull() {
+    std::lock_guard<SpinLock> guard(spinLock);
+    return stack.isFull();
+}
+
+template<typename T>
+size_t ConcurrentArrayStack<T>::size() {
+    std::lock_guard<SpinLock> guard(spinLock);
+    return stack.size();
+}
+
+template<typename T>
+T ConcurrentArrayStack<T>::top() {
+    std::lock_guard<SpinLock> guard(spinLock);
+    if (stack.isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return stack.top();
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Functions  ////////////////////
+template<typename T>
+bool ConcurrentArrayStack<T>::SpinLock::try_lock() {
+    // test before test-and-set, a failed exchange would still take the line exclusive
+    return !locked.load(std::memory_order_relaxed) && !locked.exchange(true, std::memory_order_acquire);
+}
+
+template<typename T>
+void ConcurrentArrayStack<T>::SpinLock::lock() {
+    while (!try_lock()) {
+        std::this_thread::yield();
+    }
+}
+
+template<typename T>
+void ConcurrentArrayStack<T>::SpinLock::unlock() {
+    locked.store(false, std::memory_order_release);
+}
+//////////////////////////////////////////////////////////////
+
+#endif //CONCURRENT_ARRAY_STACK_H
@@ -0,0 +1,164 @@
+#ifndef ELIMINATIONARRAY_H
+#define ELIMINATIONARRAY_H
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <thread>
+
+using std::atomic;
+
+/**
+ * Elimination array for a concurrent stack
+ *
+ * A push that could not get to the shared stack offers its value in a random
+ * slot and waits a short while. A pop that could not get to the shared stack
+ * picks a random slot and takes an offered value. The pair then cancels out
+ * without touching the shared top, which is linearizable because a push
+ * immediately followed by its pop leaves the stack unchanged.
+ *
+ * Slot states:
+ *   FREE -> CLAIMED (pusher owns the slot and writes the value)
+ *        -> OFFERING (value visible to poppers)
+ *        -> TAKING (a popper moves the value out) -> TAKEN -> FREE (by the pusher)
+ *   or, when the offer times out, OFFERING -> CLAIMED -> FREE (by the pusher)
+ *
+ * @tparam T  generic type, expected to be move constructible
+ */
+template<typename T>
+class EliminationArray {
+public:
+    // constructor
+    explicit EliminationArray(size_t slotCount = 8, size_t spinLimit = 256);
+
+    /////////////////////////  Big Five  /////////////////////////
+    // 1. destructor
+    virtual ~EliminationArray() = default;
+
+    // 2. / 3. copy, 4. / 5. move: slots are shared between threads
+    EliminationArray(const EliminationArray &) = delete;
+
+    EliminationArray& operator=(const EliminationArray &) = delete;
+
+    EliminationArray(EliminationArray &&) = delete;
+
+    EliminationArray& operator=(EliminationArray &&) = delete;
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Principle Operations  ///////////////////
+    // offer e to a pop, e is moved from only if true is returned
+    bool tryPush(T &e);
+
+    // take a value offered by a push, if there is one in the visited slot
+    std::optional<T> tryPop();
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Auxiliary Operations  ///////////////////
+    size_t slotCount() const;
+    //////////////////////////////////////////////////////////////
+
+private:
+    enum State : int {
+        FREE = 0,
+        CLAIMED = 1,
+        OFFERING = 2,
+        TAKING = 3,
+        TAKEN = 4
+    };
+
+    // one cache line per slot so that waiting threads do not disturb each other
+    struct alignas(64) Slot {
+        atomic<int> state {FREE};
+        std::optional<T> value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+
+    size_t count;
+
+    size_t spinLimit;
+
+    ///////////////////  Auxiliary Functions  ////////////////////
+    Slot& randomSlot();
+    //////////////////////////////////////////////////////////////
+};
+
+///////////////////  Function Implementation  ///////////////////
+// constructor
+template<typename T>
+EliminationArray<T>::EliminationArray(size_t slotCount, size_t spinLimit)
+        : slots {new Slot[slotCount == 0 ? 1 : slotCount]}, count {slotCount == 0 ? 1 : slotCount}, spinLimit {spinLimit} {
+}
+
+///////////////////  Principle Operations  ///////////////////
+template<typename T>
+bool EliminationArray<T>::tryPush(T &e) {
+    Slot &slot = randomSlot();
+    int expected = FREE;
+    if (!slot.state.compare_exchange_strong(expected, CLAIMED, std::memory_order_acquire)) {
+        // somebody else is using the slot, go back to the shared stack
+        return false;
+    }
+    slot.value.emplace(std::move(e));
+    slot.state.store(OFFERING, std::memory_order_release);
+
+    for (size_t i = 0; i < spinLimit; ++i) {
+        if (slot.state.load(std::memory_order_acquire) == TAKEN) {
+            slot.state.store(FREE, std::memory_order_release);
+            return true;
+        }
+    }
+
+    // withdraw the offer, unless a pop got it in the meantime
+    expected = OFFERING;
+    if (slot.state.compare_exchange_strong(expected, CLAIMED, std::memory_order_acquire)) {
+        e = std::move(*slot.value);
+        slot.value.reset();
+        slot.state.store(FREE, std::memory_order_release);
+        return false;
+    }
+    // a pop is moving the value out, wait for it to finish
+    while (slot.state.load(std::memory_order_acquire) != TAKEN) {
+        std::this_thread::yield();
+    }
+    slot.state.store(FREE, std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+std::optional<T> EliminationArray<T>::tryPop() {
+    Slot &slot = randomSlot();
+    int expected = OFFERING;
+    if (slot.state.load(std::memory_order_relaxed) != OFFERING
+        || !slot.state.compare_exchange_strong(expected, TAKING, std::memory_order_acquire)) {
+        return std::nullopt;
+    }
+    std::optional<T> ret {std::move(*slot.value)};
+    slot.value.reset();
+    slot.state.store(TAKEN, std::memory_order_release);
+    return ret;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Operations  ///////////////////
+template<typename T>
+size_t EliminationArray<T>::slotCount() const {
+    return count;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Functions  ////////////////////
+template<typename T>
+typename EliminationArray<T>::Slot& EliminationArray<T>::randomSlot() {
+    // xorshift, one state per thread, seeded from the address of the state
+    static thread_local uint64_t seed = reinterpret_cast<uintptr_t>(&seed) | 1;
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return slots[seed % count];
+}
+//////////////////////////////////////////////////////////////
+
+#endif //ELIMINATIONARRAY_H
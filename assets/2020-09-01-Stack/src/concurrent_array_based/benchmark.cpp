@@ -0,0 +1,92 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <algorithm>
+#include "ConcurrentArrayStack.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::thread;
+
+// the baseline: ArrayStack behind a single mutex
+class MutexArrayStack {
+public:
+    explicit MutexArrayStack(size_t size) : stack {size} {
+    }
+
+    void push(int e) {
+        std::lock_guard<std::mutex> lock {mutex};
+        stack.push(e);
+    }
+
+    std::optional<int> tryPop() {
+        std::lock_guard<std::mutex> lock {mutex};
+        if (stack.isEmpty()) {
+            return std::nullopt;
+        }
+        return stack.pop();
+    }
+
+private:
+    std::mutex mutex;
+
+    ArrayStack<int> stack;
+};
+
+// every thread alternates push and pop, returns million operations per second
+template<typename Stack>
+double runThroughput(Stack &stack, int threadCount, int opsPerThread) {
+    std::atomic<int> ready {0};
+    std::atomic<bool> go {false};
+    vector<thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            ready.fetch_add(1);
+            while (!go.load()) {
+            }
+            for (int i = 0; i < opsPerThread / 2; ++i) {
+                stack.push(t * opsPerThread + i);
+                stack.tryPop();
+            }
+        });
+    }
+    while (ready.load() < threadCount) {
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true);
+    for (thread &th : threads) {
+        th.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(threadCount) * opsPerThread / elapsed.count() / 1e6;
+}
+
+int main(int argc, char **argv) {
+    int opsPerThread = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    int maxThreads = argc > 2 ? std::stoi(argv[2]) : 64;
+
+    // scaling curve: 1, 2, 4, ..., maxThreads
+    cout << "threads,elimination_mops,single_slot_mops,mutex_mops" << endl;
+    for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        ConcurrentArrayStack<int> elimination {1024, static_cast<size_t>(std::max(1, threadCount / 2))};
+        // a single slot shows how much the elimination width matters
+        ConcurrentArrayStack<int> singleSlot {1024, 1};
+        MutexArrayStack mutexed {1024};
+
+        cout << threadCount << "," << std::fixed << std::setprecision(2)
+             << runThroughput(elimination, threadCount, opsPerThread) << ","
+             << runThroughput(singleSlot, threadCount, opsPerThread) << ","
+             << runThroughput(mutexed, threadCount, opsPerThread) << endl;
+    }
+
+    return 0;
+}
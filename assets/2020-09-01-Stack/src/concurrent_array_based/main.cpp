@@ -0,0 +1,264 @@
+#include <iostream>
+#include <assert.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "ConcurrentArrayStack.h"
+#include "BlockingArrayStack.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::thread;
+
+void testIntStack() {
+    // test constructor
+    ConcurrentArrayStack<int> cas{2};
+    assert(cas.isEmpty() == true);
+    assert(cas.isFull() == false);
+    assert(!cas.tryPop());
+
+    // test push, top, size, isFull, growth
+    cas.push(10);
+    cas.push(20);
+    assert(cas.isFull() == true);
+    cas.push(30);
+    assert(cas.isFull() == false);
+    assert(cas.top() == 30);
+    assert(cas.size() == 3);
+
+    // test pop, tryPop
+    assert(cas.pop() == 30);
+    assert(cas.tryPop().value() == 20);
+    assert(cas.pop() == 10);
+    assert(cas.isEmpty() == true);
+
+    // test pop on an empty stack
+    bool thrown = false;
+    try {
+        cas.pop();
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+}
+
+void testStress() {
+    // every value is pushed exactly once by the producers,
+    // and must be popped exactly once by the consumers, eliminated or not
+    const int producers = 4;
+    const int consumers = 4;
+    const int perProducer = 200000;
+    const int total = producers * perProducer;
+
+    ConcurrentArrayStack<int> cas{16, 4};
+    vector<std::atomic<int>> seen(total);
+    std::atomic<int> popped {0};
+
+    vector<thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            for (int i = 0; i < perProducer; ++i) {
+                cas.push(p * perProducer + i);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&]() {
+            while (popped.load() < total) {
+                std::optional<int> v = cas.tryPop();
+                if (v) {
+                    seen[*v].fetch_add(1);
+                    popped.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (thread &t : threads) {
+        t.join();
+    }
+
+    assert(cas.isEmpty() == true);
+    for (int i = 0; i < total; ++i) {
+        assert(seen[i].load() == 1);
+    }
+}
+
+void testStressString() {
+    // balanced push/pop on every thread, the case elimination is built for
+    const int workers = 8;
+    const int rounds = 50000;
+
+    ConcurrentArrayStack<std::string> cas{1, 4};
+    std::atomic<long> pushed {0};
+    std::atomic<long> popped {0};
+    vector<thread> threads;
+    for (int w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w]() {
+            for (int i = 0; i < rounds; ++i) {
+                cas.push(std::string(48, static_cast<char>('a' + w)));
+                pushed.fetch_add(1);
+                std::optional<std::string> s = cas.tryPop();
+                if (s) {
+                    assert(s->size() == 48);
+                    popped.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (thread &t : threads) {
+        t.join();
+    }
+    assert(static_cast<long>(cas.size()) == pushed.load() - popped.load());
+}
+
+void testBlockingStack() {
+    using std::chrono::milliseconds;
+
+    // test constructor
+    BlockingArrayStack<int> bas{2};
+    assert(bas.isEmpty() == true);
+    assert(bas.getCapacity() == 2);
+
+    // test push, pop, timed variants at the bound
+    bas.push(10);
+    assert(bas.tryPush(20, milliseconds(1)) == true);
+    assert(bas.isFull() == true);
+    auto start = std::chrono::steady_clock::now();
+    assert(bas.tryPush(30, milliseconds(20)) == false);
+    assert(std::chrono::steady_clock::now() - start >= milliseconds(20));
+    assert(bas.size() == 2);
+    assert(bas.pop() == 20);
+    assert(bas.tryPop(milliseconds(1)).value() == 10);
+    assert(!bas.tryPop(milliseconds(5)));
+
+    // test a blocked pop is woken by a push
+    thread producer([&]() {
+        std::this_thread::sleep_for(milliseconds(20));
+        bas.push(40);
+    });
+    assert(bas.pop() == 40);
+    producer.join();
+
+    // test close: waiters wake up, the rest is drained, then pops fail
+    bas.push(50);
+    bas.close();
+    assert(bas.tryPush(60, milliseconds(1)) == false);
+    assert(bas.pop() == 50);
+    bool thrown = false;
+    try {
+        bas.pop();
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+}
+
+void testBlockingPipeline() {
+    // a small bound between fast producers and consumers:
+    // every value arrives exactly once and the bound is never exceeded
+    const int producers = 3;
+    const int consumers = 3;
+    const int perProducer = 50000;
+    const int total = producers * perProducer;
+
+    BlockingArrayStack<int> bas{8};
+    vector<std::atomic<int>> seen(total);
+    std::atomic<bool> overflow {false};
+
+    vector<thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            for (int i = 0; i < perProducer; ++i) {
+                bas.push(p * perProducer + i);
+                if (bas.size() > bas.getCapacity()) {
+                    overflow.store(true);
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&]() {
+            while (true) {
+                std::optional<int> v = bas.tryPop(std::chrono::milliseconds(100));
+                if (!v) {
+                    if (bas.isClosed()) {
+                        return;
+                    }
+                    continue;
+                }
+                seen[*v].fetch_add(1);
+            }
+        });
+    }
+    for (int p = 0; p < producers; ++p) {
+        threads[p].join();
+    }
+    bas.close();
+    for (int c = 0; c < consumers; ++c) {
+        threads[producers + c].join();
+    }
+
+    assert(overflow.load() == false);
+    assert(bas.isEmpty() == true);
+    for (int i = 0; i < total; ++i) {
+        assert(seen[i].load() == 1);
+    }
+}
+
+// an element whose moves can be made to throw
+struct Fragile {
+    static bool failMoves;
+
+    int value;
+
+    explicit Fragile(int value) : value {value} {
+    }
+
+    Fragile(const Fragile &f) = default;
+
+    Fragile(Fragile &&f) : value {f.value} {
+        if (failMoves) {
+            throw std::runtime_error("move failed.");
+        }
+    }
+
+    Fragile& operator=(const Fragile &f) = default;
+
+    Fragile& operator=(Fragile &&f) = default;
+};
+
+bool Fragile::failMoves = false;
+
+void testThrowingElement() {
+    // a throwing move inside the critical section must not leave the lock taken
+    ConcurrentArrayStack<Fragile> cas{4};
+    cas.push(Fragile {1});
+    cas.push(Fragile {2});
+    Fragile::failMoves = true;
+    bool thrown = false;
+    try {
+        cas.tryPop();
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+    Fragile::failMoves = false;
+    assert(cas.size() == 2);
+    assert(cas.pop().value == 2);
+    cas.push(Fragile {3});
+    assert(cas.top().value == 3);
+}
+
+int main() {
+    testIntStack();
+    testThrowingElement();
+    testStress();
+    testStressString();
+    testBlockingStack();
+    testBlockingPipeline();
+
+    return 0;
+}
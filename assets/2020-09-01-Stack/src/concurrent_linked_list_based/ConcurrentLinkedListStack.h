@@ -0,0 +1,200 @@
+#ifndef CONCURRENTLINKEDLISTSTACK_H
+#define CONCURRENTLINKEDLISTSTACK_H
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include "EpochReclaimer.h"
+
+using std::atomic;
+using std::string;
+
+/**
+ * Lock-free linked list based Stack (Treiber stack)
+ *
+ * head is a tagged pointer: the low 48 bits hold the node address and the
+ * high 16 bits a version that is bumped on every successful CAS, so a head
+ * that was popped and pushed again between a load and a CAS is detected (ABA).
+ * Popped nodes are retired to the EpochReclaimer instead of being deleted,
+ * because a concurrent pop may still be reading their next pointer.
+ *
+ * Data in a published node is never modified, pop copies it out, so top()
+ * can safely read it while another thread pops the same node.
+ *
+ * @tparam T  generic type, expected to be copy constructible
+ */
+template<typename T>
+class ConcurrentLinkedListStack {
+public:
+    // constructor
+    ConcurrentLinkedListStack();
+
+    /////////////////////////  Big Five  /////////////////////////
+    // 1. destructor (no other thread may access the stack any more)
+    virtual ~ConcurrentLinkedListStack();
+
+    // 2. / 3. copy, 4. / 5. move: a shared stack is identified by its address
+    ConcurrentLinkedListStack(const ConcurrentLinkedListStack &) = delete;
+
+    ConcurrentLinkedListStack& operator=(const ConcurrentLinkedListStack &) = delete;
+
+    ConcurrentLinkedListStack(ConcurrentLinkedListStack &&) = delete;
+
+    ConcurrentLinkedListStack& operator=(ConcurrentLinkedListStack &&) = delete;
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Principle Operations  ///////////////////
+    void push(T e);
+
+    T pop();
+
+    // pop that reports an empty stack with std::nullopt instead of throwing
+    std::optional<T> tryPop();
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Auxiliary Operations  ///////////////////
+    // the results below are snapshots, they may be stale once returned
+    bool isEmpty() const;
+
+    size_t size() const;
+
+    T top() const;
+    //////////////////////////////////////////////////////////////
+
+private:
+    struct Node {
+        const T data;
+        Node *next;
+
+        // Node constructor
+        explicit Node(T data, Node *next = nullptr) : data {std::move(data)}, next {next} {
+        }
+    };
+
+    static_assert(sizeof(void *) == 8, "tagged pointers need a 64-bit address space.");
+
+    static constexpr uint64_t POINTER_MASK = (uint64_t(1) << 48) - 1;
+
+    // tagged pointer to the top node
+    atomic<uint64_t> head {0};
+
+    atomic<size_t> count {0};
+
+    ///////////////////  Auxiliary Functions  ////////////////////
+    static Node* pointerOf(uint64_t tagged);
+
+    static uint64_t nextTagged(uint64_t tagged, Node *node);
+
+    static void deleteNode(void *node);
+    //////////////////////////////////////////////////////////////
+};
+
+///////////////////  Function Implementation  ///////////////////
+// constructor
+template<typename T>
+ConcurrentLinkedListStack<T>::ConcurrentLinkedListStack() = default;
+
+/////////////////////////  Big Five  /////////////////////////
+// 1. destructor
+template<typename T>
+ConcurrentLinkedListStack<T>::~ConcurrentLinkedListStack() {
+    // nodes still in the stack were never retired, delete them directly
+    Node *it = pointerOf(head.load());
+    while (it != nullptr) {
+        Node *next = it->next;
+        delete it;
+        it = next;
+    }
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Principle Operations  ///////////////////
+template<typename T>
+void ConcurrentLinkedListStack<T>::push(T e) {
+    Node *newNode = new Node(std::move(e));
+    uint64_t oldHead = head.load(std::memory_order_relaxed);
+    do {
+        // newNode is private until the CAS succeeds
+        newNode->next = pointerOf(oldHead);
+    } while (!head.compare_exchange_weak(oldHead, nextTagged(oldHead, newNode),
+                                         std::memory_order_release, std::memory_order_relaxed));
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename T>
+T ConcurrentLinkedListStack<T>::pop() {
+    std::optional<T> ret = tryPop();
+    if (!ret) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return std::move(*ret);
+}
+
+template<typename T>
+std::optional<T> ConcurrentLinkedListStack<T>::tryPop() {
+    EpochReclaimer &reclaimer = EpochReclaimer::instance();
+    // the pin keeps oldHead alive even if another thread pops it first
+    EpochReclaimer::Guard guard {reclaimer};
+
+    uint64_t oldHead = head.load(std::memory_order_acquire);
+    Node *node;
+    do {
+        node = pointerOf(oldHead);
+        if (node == nullptr) {
+            return std::nullopt;
+        }
+    } while (!head.compare_exchange_weak(oldHead, nextTagged(oldHead, node->next),
+                                         std::memory_order_acquire, std::memory_order_acquire));
+    count.fetch_sub(1, std::memory_order_relaxed);
+
+    // retiring first cannot free node while this thread is pinned,
+    // and a throwing copy below cannot leak it
+    reclaimer.retire(node, &ConcurrentLinkedListStack::deleteNode);
+    return std::optional<T> {node->data};
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Operations  ///////////////////
+template<typename T>
+bool ConcurrentLinkedListStack<T>::isEmpty() const {
+    return pointerOf(head.load(std::memory_order_acquire)) == nullptr;
+}
+
+template<typename T>
+size_t ConcurrentLinkedListStack<T>::size() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+template<typename T>
+T ConcurrentLinkedListStack<T>::top() const {
+    EpochReclaimer::Guard guard {EpochReclaimer::instance()};
+    Node *node = pointerOf(head.load(std::memory_order_acquire));
+    if (node == nullptr) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return node->data;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Functions  ////////////////////
+template<typename T>
+typename ConcurrentLinkedListStack<T>::Node* ConcurrentLinkedListStack<T>::pointerOf(uint64_t tagged) {
+    return reinterpret_cast<Node *>(static_cast<uintptr_t>(tagged & POINTER_MASK));
+}
+
+template<typename T>
+uint64_t ConcurrentLinkedListStack<T>::nextTagged(uint64_t tagged, Node *node) {
+    // bump the version, the pointer bits are replaced
+    uint64_t version = (tagged >> 48) + 1;
+    return (version << 48) | (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(node)) & POINTER_MASK);
+}
+
+template<typename T>
+void ConcurrentLinkedListStack<T>::deleteNode(void *node) {
+    delete static_cast<Node *>(node);
+}
+//////////////////////////////////////////////////////////////
+
+#endif //CONCURRENTLINKEDLISTSTACK_H
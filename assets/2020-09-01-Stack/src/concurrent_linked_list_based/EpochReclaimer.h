@@ -0,0 +1,199 @@
+#ifndef EPOCHRECLAIMER_H
+#define EPOCHRECLAIMER_H
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+
+using std::atomic;
+using std::vector;
+
+/**
+ * Epoch based memory reclamation
+ *
+ * A thread pins the current global epoch while it may dereference shared
+ * nodes, and retires a node instead of deleting it once it is unlinked.
+ * The global epoch only advances when every pinned thread has seen it, so
+ * a node retired in epoch e cannot be reachable by anybody once the global
+ * epoch reaches e + 2, and is freed then.
+ *
+ * Every thread claims a record on its first pin. When the thread exits the
+ * record is released together with its pending garbage, and the next thread
+ * claiming it frees that garbage later. Remaining garbage is freed when the
+ * process exits.
+ */
+class EpochReclaimer {
+public:
+    // keeps the calling thread pinned while it is alive
+    class Guard {
+    public:
+        explicit Guard(EpochReclaimer &reclaimer) : reclaimer {reclaimer} {
+            reclaimer.enter();
+        }
+
+        ~Guard() {
+            reclaimer.leave();
+        }
+
+        Guard(const Guard &) = delete;
+
+        Guard& operator=(const Guard &) = delete;
+
+    private:
+        EpochReclaimer &reclaimer;
+    };
+
+    // the process wide reclamation domain
+    static EpochReclaimer& instance() {
+        static EpochReclaimer reclaimer;
+        return reclaimer;
+    }
+
+    /////////////////////////  Big Five  /////////////////////////
+    // 1. destructor
+    virtual ~EpochReclaimer() {
+        // no other thread is running at this point
+        for (size_t i = 0; i < MAX_THREADS; ++i) {
+            for (Retired &r : records[i].retired) {
+                r.deleter(r.ptr);
+            }
+            records[i].retired.clear();
+        }
+    }
+
+    // 2. / 3. copy, 4. / 5. move: a domain is a singleton
+    EpochReclaimer(const EpochReclaimer &) = delete;
+
+    EpochReclaimer& operator=(const EpochReclaimer &) = delete;
+
+    EpochReclaimer(EpochReclaimer &&) = delete;
+
+    EpochReclaimer& operator=(EpochReclaimer &&) = delete;
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Principle Operations  ///////////////////
+    Guard pin() {
+        return Guard(*this);
+    }
+
+    // hand over an unlinked object, deleter(ptr) runs once no pinned thread can see it
+    void retire(void *ptr, void (*deleter)(void *)) {
+        ThreadRecord &rec = localRecord();
+        rec.retired.push_back(Retired {ptr, deleter, globalEpoch.load()});
+        if (++rec.retiredSinceCollect >= COLLECT_THRESHOLD) {
+            rec.retiredSinceCollect = 0;
+            tryAdvance();
+            collect(rec);
+        }
+    }
+    //////////////////////////////////////////////////////////////
+
+private:
+    struct Retired {
+        void *ptr;
+        void (*deleter)(void *);
+        uint64_t epoch;
+    };
+
+    struct alignas(64) ThreadRecord {
+        // claimed by a live thread
+        atomic<bool> inUse {false};
+        // (pinned epoch << 1) | 1 while pinned, 0 otherwise
+        atomic<uint64_t> state {0};
+        // only touched by the owning thread
+        size_t pinDepth {0};
+        size_t retiredSinceCollect {0};
+        vector<Retired> retired;
+    };
+
+    // releases the record of a thread when the thread exits
+    struct RecordHolder {
+        ThreadRecord *rec {nullptr};
+
+        ~RecordHolder() {
+            if (rec != nullptr) {
+                rec->inUse.store(false);
+            }
+        }
+    };
+
+    static constexpr size_t MAX_THREADS = 512;
+
+    static constexpr size_t COLLECT_THRESHOLD = 64;
+
+    atomic<uint64_t> globalEpoch {0};
+
+    // number of records ever claimed, scans stop there
+    atomic<size_t> highWater {0};
+
+    ThreadRecord records[MAX_THREADS];
+
+    EpochReclaimer() = default;
+
+    ///////////////////  Auxiliary Functions  ////////////////////
+    ThreadRecord& localRecord() {
+        static thread_local RecordHolder holder;
+        if (holder.rec == nullptr) {
+            holder.rec = claimRecord();
+        }
+        return *holder.rec;
+    }
+
+    ThreadRecord* claimRecord() {
+        for (size_t i = 0; i < MAX_THREADS; ++i) {
+            bool expected = false;
+            if (!records[i].inUse.load() && records[i].inUse.compare_exchange_strong(expected, true)) {
+                // raise the high water mark to cover this record
+                size_t hw = highWater.load();
+                while (hw < i + 1 && !highWater.compare_exchange_weak(hw, i + 1)) {
+                }
+                return &records[i];
+            }
+        }
+        throw std::runtime_error("EpochReclaimer: too many threads.");
+    }
+
+    void enter() {
+        ThreadRecord &rec = localRecord();
+        if (rec.pinDepth++ == 0) {
+            // publish the pin before any shared node is read (seq_cst store)
+            rec.state.store((globalEpoch.load() << 1) | 1);
+        }
+    }
+
+    void leave() {
+        ThreadRecord &rec = localRecord();
+        if (--rec.pinDepth == 0) {
+            rec.state.store(0);
+        }
+    }
+
+    void tryAdvance() {
+        uint64_t epoch = globalEpoch.load();
+        size_t n = highWater.load();
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t s = records[i].state.load();
+            if ((s & 1) != 0 && (s >> 1) != epoch) {
+                // a thread is still pinned in an older epoch
+                return;
+            }
+        }
+        globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+    }
+
+    void collect(ThreadRecord &rec) {
+        uint64_t epoch = globalEpoch.load();
+        // retired epochs are non-decreasing, so the reclaimable objects form a prefix
+        size_t reclaimable = 0;
+        while (reclaimable < rec.retired.size() && rec.retired[reclaimable].epoch + 2 <= epoch) {
+            rec.retired[reclaimable].deleter(rec.retired[reclaimable].ptr);
+            reclaimable++;
+        }
+        rec.retired.erase(rec.retired.begin(), rec.retired.begin() + reclaimable);
+    }
+    //////////////////////////////////////////////////////////////
+};
+
+#endif //EPOCHRECLAIMER_H
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include "ConcurrentLinkedListStack.h"
+#include "../linked_list_based/LinkedListStack.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::thread;
+
+// the baseline: LinkedListStack behind a single mutex
+class MutexLinkedListStack {
+public:
+    void push(int e) {
+        std::lock_guard<std::mutex> lock {mutex};
+        stack.push(e);
+    }
+
+    std::optional<int> tryPop() {
+        std::lock_guard<std::mutex> lock {mutex};
+        if (stack.isEmpty()) {
+            return std::nullopt;
+        }
+        return stack.pop();
+    }
+
+private:
+    std::mutex mutex;
+
+    LinkedListStack<int> stack;
+};
+
+// every thread alternates push and pop, returns million operations per second
+template<typename Stack>
+double runThroughput(int threadCount, int opsPerThread) {
+    Stack stack;
+    // pre-fill so that pops rarely see an empty stack
+    for (int i = 0; i < 1024; ++i) {
+        stack.push(i);
+    }
+
+    std::atomic<int> ready {0};
+    std::atomic<bool> go {false};
+    vector<thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            ready.fetch_add(1);
+            while (!go.load()) {
+            }
+            for (int i = 0; i < opsPerThread / 2; ++i) {
+                stack.push(t * opsPerThread + i);
+                stack.tryPop();
+            }
+        });
+    }
+    while (ready.load() < threadCount) {
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true);
+    for (thread &th : threads) {
+        th.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(threadCount) * opsPerThread / elapsed.count() / 1e6;
+}
+
+int main(int argc, char **argv) {
+    int opsPerThread = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    int maxThreads = static_cast<int>(std::max(2u, 2 * std::thread::hardware_concurrency()));
+
+    cout << "threads,lock_free_mops,mutex_mops" << endl;
+    for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        double lockFree = runThroughput<ConcurrentLinkedListStack<int>>(threadCount, opsPerThread);
+        double mutexed = runThroughput<MutexLinkedListStack>(threadCount, opsPerThread);
+        cout << threadCount << "," << std::fixed << std::setprecision(2)
+             << lockFree << "," << mutexed << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <iostream>
+#include <assert.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include "ConcurrentLinkedListStack.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::thread;
+
+void testIntStack() {
+    // test constructor
+    ConcurrentLinkedListStack<int> clls;
+    assert(clls.isEmpty() == true);
+    assert(!clls.tryPop());
+
+    // test push, top, size
+    clls.push(10);
+    clls.push(20);
+    clls.push(30);
+    assert(clls.top() == 30);
+    assert(clls.size() == 3);
+
+    // test pop, tryPop
+    assert(clls.pop() == 30);
+    assert(clls.tryPop().value() == 20);
+    assert(clls.pop() == 10);
+    assert(clls.isEmpty() == true);
+
+    // test pop on an empty stack
+    bool thrown = false;
+    try {
+        clls.pop();
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+}
+
+void testStress() {
+    // every value is pushed exactly once by the producers,
+    // and must be popped exactly once by the consumers
+    const int producers = 4;
+    const int consumers = 4;
+    const int perProducer = 200000;
+    const int total = producers * perProducer;
+
+    ConcurrentLinkedListStack<int> clls;
+    vector<std::atomic<int>> seen(total);
+    std::atomic<int> popped {0};
+
+    vector<thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            for (int i = 0; i < perProducer; ++i) {
+                clls.push(p * perProducer + i);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&]() {
+            while (popped.load() < total) {
+                std::optional<int> v = clls.tryPop();
+                if (v) {
+                    seen[*v].fetch_add(1);
+                    popped.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (thread &t : threads) {
+        t.join();
+    }
+
+    assert(clls.isEmpty() == true);
+    assert(clls.size() == 0);
+    for (int i = 0; i < total; ++i) {
+        assert(seen[i].load() == 1);
+    }
+}
+
+void testStressString() {
+    // mixed push/pop on every thread with heap-owning elements,
+    // a node freed too early shows up under AddressSanitizer
+    const int workers = 8;
+    const int rounds = 50000;
+
+    ConcurrentLinkedListStack<std::string> clls;
+    vector<thread> threads;
+    for (int w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w]() {
+            for (int i = 0; i < rounds; ++i) {
+                clls.push(std::string(48, static_cast<char>('a' + w)));
+                std::optional<std::string> s = clls.tryPop();
+                assert(s && s->size() == 48);
+                if (i % 7 == 0 && !clls.isEmpty()) {
+                    try {
+                        assert(clls.top().size() == 48);
+                    } catch (const std::runtime_error &e) {
+                        // emptied by another thread in between
+                    }
+                }
+            }
+        });
+    }
+    for (thread &t : threads) {
+        t.join();
+    }
+    assert(clls.isEmpty() == true);
+}
+
+int main() {
+    testIntStack();
+    testStress();
+    testStressString();
+
+    return 0;
+}
@@ -3,13 +3,33 @@
 
 #include <vector>
 #include <string>
+#include <utility>
+#include <optional>
 #include <stdexcept>
+#include <type_traits>
+#include "NodePool.h"
+#include "../array_based/StatsPolicy.h"
 
 using std::vector;
 using std::string;
 
-template<typename T>
-class LinkedListStack {
+/**
+ * Linked list based Stack
+ *
+ * Nodes are taken from a NodePool instead of new/delete, popped nodes are
+ * recycled by the pool.
+ *
+ * @tparam T                generic type
+ * @tparam ThreadLocalPool  false: every stack owns its pool, the destructor and
+ *                                 clear() free whole chunks at once
+ *                          true:  all stacks of T on a thread share one pool,
+ *                                 nodes are recycled one by one, so a stack
+ *                                 must be destroyed on the thread that filled it
+ * @tparam StatsPolicy      NoStats or CountingStats, see StatsPolicy.h
+ *                          a growth event is a new pool chunk
+ */
+template<typename T, bool ThreadLocalPool = false, typename StatsPolicy = NoStats>
+class LinkedListStack : private StatsPolicy {
 public:
     // constructor
     LinkedListStack();
@@ -36,6 +56,19 @@ public:
     void push(T e);
 
     T pop();
+
+    // pop that reports an empty stack with std::nullopt instead of throwing
+    std::optional<T> tryPop() noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    // push [first, last) in order, *first ends up deepest
+    // the nodes are linked into a chain first and spliced onto head once
+    // popN redirects head once after draining
+    template<typename InputIt>
+    void pushRange(InputIt first, InputIt last);
+
+    // pop n elements into out in pop order (top first), returns the end of the output
+    template<typename OutputIt>
+    OutputIt popN(size_t n, OutputIt out);
     //////////////////////////////////////////////////////////////
 
     ///////////////////  Auxiliary Operations  ///////////////////
@@ -47,9 +80,15 @@ public:
 
     T top() const;
 
+    // top that reports an empty stack with std::nullopt instead of throwing
+    std::optional<T> tryTop() const noexcept(std::is_nothrow_copy_constructible<T>::value);
+
     void clear();
 
     string toString() const;
+
+    // counters of StatsPolicy plus the current depth and footprint
+    StackStats stats() const;
     //////////////////////////////////////////////////////////////
 private:
     struct Node {
@@ -57,15 +96,26 @@ private:
         Node *next;
 
         // Node constructor
-        explicit Node(T data, Node *next = nullptr) : data {data}, next {next} {
+        explicit Node(T data, Node *next = nullptr) : data {std::move(data)}, next {next} {
         }
     };
 
-    Node *head;
+    Node *head {nullptr};
 
     size_t count {};
 
+    // only used when ThreadLocalPool is false
+    NodePool<Node> ownPool;
+
     ///////////////////  Auxiliary Functions  ////////////////////
+    NodePool<Node>& pool();
+
+    // pool().create, reporting new chunks to StatsPolicy
+    template<typename... Args>
+    Node* createNode(Args&&... args);
+
+    void destroyNodes();
+
     void deepcopy(const LinkedListStack &);
 
     void deepmove(LinkedListStack &);
@@ -76,30 +126,28 @@ private:
 
 ///////////////////  Function Implementation  ///////////////////
 // constructor
-template<typename T>
-LinkedListStack<T>::LinkedListStack() {
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+LinkedListStack<T, ThreadLocalPool, StatsPolicy>::LinkedListStack() {
     count = 0;
     head = nullptr;
 }
 
 /////////////////////////  Big Five  /////////////////////////
 // 1. destructor
-template<typename T>
-LinkedListStack<T>::~LinkedListStack() {
-    while (!isEmpty()) {
-        pop();
-    }
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+LinkedListStack<T, ThreadLocalPool, StatsPolicy>::~LinkedListStack() {
+    destroyNodes();
 }
 
 // 2. copy constructor
-template<typename T>
-LinkedListStack<T>::LinkedListStack(const LinkedListStack &lls) {
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+LinkedListStack<T, ThreadLocalPool, StatsPolicy>::LinkedListStack(const LinkedListStack &lls) : StatsPolicy() {
     deepcopy(lls);
 }
 
 // 3. copy assignment operator=
-template<typename T>
-LinkedListStack<T>& LinkedListStack<T>::operator=(const LinkedListStack &lls) {
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+LinkedListStack<T, ThreadLocalPool, StatsPolicy>& LinkedListStack<T, ThreadLocalPool, StatsPolicy>::operator=(const LinkedListStack &lls) {
     // check self-assignment
     if (this == &lls) {
         return *this;
@@ -110,14 +158,14 @@ LinkedListStack<T>& LinkedListStack<T>::operator=(const LinkedListStack &lls) {
 }
 
 // 4. move constructor
-template<typename T>
-LinkedListStack<T>::LinkedListStack(LinkedListStack &&lls) noexcept {
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+LinkedListStack<T, ThreadLocalPool, StatsPolicy>::LinkedListStack(LinkedListStack &&lls) noexcept : StatsPolicy() {
     deepmove(lls);
 }
 
 // 5. move assignment operator=
-template<typename T>
-LinkedListStack<T>& LinkedListStack<T>::operator=(LinkedListStack &&lls) noexcept {
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+LinkedListStack<T, ThreadLocalPool, StatsPolicy>& LinkedListStack<T, ThreadLocalPool, StatsPolicy>::operator=(LinkedListStack &&lls) noexcept {
     // check self-assignment
     if (this == &lls) {
         return *this;
@@ -130,56 +178,141 @@ LinkedListStack<T>& LinkedListStack<T>::operator=(LinkedListStack &&lls) noexcep
 /////////////////////////////////////////////////////////////////
 
 ///////////////////  Principle Operations  ///////////////////
-template<typename T>
-void LinkedListStack<T>::push(T e) {
-    // create a new Node
-    Node *newNode = new Node(e, head);
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+void LinkedListStack<T, ThreadLocalPool, StatsPolicy>::push(T e) {
+    // create a new Node from the pool
+    Node *newNode = createNode(std::move(e), head);
     // redirect head
     head = newNode;
     count++;
+    this->onPush(1, count);
 }
 
-template<typename T>
-T LinkedListStack<T>::pop() {
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+template<typename InputIt>
+void LinkedListStack<T, ThreadLocalPool, StatsPolicy>::pushRange(InputIt first, InputIt last) {
+    if (first == last) {
+        return;
+    }
+    // the first node of the chain becomes the bottom, remember it for the splice
+    Node *chainTop = createNode(*first, nullptr);
+    Node *chainBottom = chainTop;
+    size_t n = 1;
+    try {
+        for (++first; first != last; ++first) {
+            chainTop = createNode(*first, chainTop);
+            n++;
+        }
+    } catch (...) {
+        // all or nothing, the stack has not been touched yet
+        while (chainTop != nullptr) {
+            Node *next = chainTop->next;
+            pool().destroy(chainTop);
+            chainTop = next;
+        }
+        throw;
+    }
+    // splice
+    chainBottom->next = head;
+    head = chainTop;
+    count += n;
+    this->onPush(n, count);
+}
+
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+template<typename OutputIt>
+OutputIt LinkedListStack<T, ThreadLocalPool, StatsPolicy>::popN(size_t n, OutputIt out) {
+    if (n > count) {
+        throw std::runtime_error("Stack has fewer elements than requested.");
+    }
+    // drain the n top nodes, head is redirected once at the end
+    Node *it = head;
+    size_t i = 0;
+    try {
+        for (; i < n; ++i, ++out) {
+            *out = std::move(it->data);
+            Node *next = it->next;
+            pool().destroy(it);
+            it = next;
+        }
+    } catch (...) {
+        // keep the stack consistent with what has been popped so far
+        head = it;
+        count -= i;
+        this->onPop(i);
+        throw;
+    }
+    head = it;
+    count -= n;
+    this->onPop(n);
+    return out;
+}
+
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+T LinkedListStack<T, ThreadLocalPool, StatsPolicy>::pop() {
     if (isEmpty()) {
         throw std::runtime_error("Stack is empty.");
     }
-    T ret = head->data;
+    Node *oldHead = head;
+    T ret {std::move(oldHead->data)};
+    head = head->next;
+    count--;
+    this->onPop(1);
+    // recycle the node
+    pool().destroy(oldHead);
+    return ret;
+}
+
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+std::optional<T> LinkedListStack<T, ThreadLocalPool, StatsPolicy>::tryPop() noexcept(std::is_nothrow_move_constructible<T>::value) {
+    if (isEmpty()) {
+        return std::nullopt;
+    }
+    Node *oldHead = head;
+    std::optional<T> ret {std::move(oldHead->data)};
     head = head->next;
     count--;
+    this->onPop(1);
+    pool().destroy(oldHead);
     return ret;
 }
 
 /////////////////////////////////////////////////////////////////
 
 ///////////////////  Auxiliary Operations  ///////////////////
-template<typename T>
-bool LinkedListStack<T>::isEmpty() const {
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+bool LinkedListStack<T, ThreadLocalPool, StatsPolicy>::isEmpty() const {
     return count == 0;
 }
 
-template<typename T>
-size_t LinkedListStack<T>::size() const {
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+size_t LinkedListStack<T, ThreadLocalPool, StatsPolicy>::size() const {
     return count;
 }
 
-template<typename T>
-T LinkedListStack<T>::top() const {
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+T LinkedListStack<T, ThreadLocalPool, StatsPolicy>::top() const {
     if (isEmpty()) {
         throw std::runtime_error("Stack is empty.");
     }
     return head->data;
 }
 
-template<typename T>
-void LinkedListStack<T>::clear() {
-    while (!isEmpty()) {
-        pop();
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+std::optional<T> LinkedListStack<T, ThreadLocalPool, StatsPolicy>::tryTop() const noexcept(std::is_nothrow_copy_constructible<T>::value) {
+    if (isEmpty()) {
+        return std::nullopt;
     }
+    return head->data;
+}
+
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+void LinkedListStack<T, ThreadLocalPool, StatsPolicy>::clear() {
+    destroyNodes();
 }
 
-template<typename T>
-string LinkedListStack<T>::toString() const {
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+string LinkedListStack<T, ThreadLocalPool, StatsPolicy>::toString() const {
     if (isEmpty()) {
         return "";
     }
@@ -191,49 +324,100 @@ string LinkedListStack<T>::toString() const {
     return ret;
 }
 
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+StackStats LinkedListStack<T, ThreadLocalPool, StatsPolicy>::stats() const {
+    StackStats ret = StatsPolicy::snapshot();
+    ret.depth = count;
+    if constexpr (ThreadLocalPool) {
+        // the chunks are shared, count the nodes of this stack only
+        ret.footprintBytes = count * sizeof(Node);
+    } else {
+        ret.footprintBytes = ownPool.slotCount() * sizeof(Node);
+    }
+    return ret;
+}
+
 /////////////////////////////////////////////////////////////////
 
 ////////////////////  Auxiliary Functions  //////////////////////
-template<typename T>
-void LinkedListStack<T>::deepcopy(const LinkedListStack &lls) {
-    // empty the stack
-    clear();
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+NodePool<typename LinkedListStack<T, ThreadLocalPool, StatsPolicy>::Node>& LinkedListStack<T, ThreadLocalPool, StatsPolicy>::pool() {
+    if constexpr (ThreadLocalPool) {
+        static thread_local NodePool<Node> sharedPool;
+        return sharedPool;
+    } else {
+        return ownPool;
+    }
+}
 
-    // element-wise copy
-    // store all the elements in lls
-    vector<T> temp;
-    for (Node *it = lls.head; it != nullptr; it = it->next) {
-        // store a deep copy
-        T t {it->data};
-        temp.push_back(t);
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+template<typename... Args>
+typename LinkedListStack<T, ThreadLocalPool, StatsPolicy>::Node* LinkedListStack<T, ThreadLocalPool, StatsPolicy>::createNode(Args&&... args) {
+    if constexpr (StatsPolicy::enabled) {
+        size_t chunks = pool().chunkCount();
+        Node *node = pool().create(std::forward<Args>(args)...);
+        if (pool().chunkCount() != chunks) {
+            this->onGrow(1);
+        }
+        return node;
+    } else {
+        return pool().create(std::forward<Args>(args)...);
     }
+}
 
-    // element-wise push (push from rear to head)
-    for (int i = temp.size() - 1; i >= 0; --i) {
-        push(temp.at(i));
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+void LinkedListStack<T, ThreadLocalPool, StatsPolicy>::destroyNodes() {
+    if constexpr (ThreadLocalPool) {
+        // the chunks are shared with other stacks, recycle node by node
+        while (head != nullptr) {
+            Node *next = head->next;
+            pool().destroy(head);
+            head = next;
+        }
+    } else {
+        // run the element destructors only if they do anything, then free whole chunks
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            for (Node *it = head; it != nullptr; it = it->next) {
+                it->data.~T();
+            }
+        }
+        ownPool.release();
+        head = nullptr;
     }
+    count = 0;
 }
 
-template<typename T>
-void LinkedListStack<T>::deepmove(LinkedListStack &lls) {
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+void LinkedListStack<T, ThreadLocalPool, StatsPolicy>::deepcopy(const LinkedListStack &lls) {
     // empty the stack
     clear();
 
-    // element-wise copy
-    // store all the elements in lls
-    vector<T> temp;
+    // element-wise copy, appending at the tail keeps the order without a temporary buffer
+    Node **tail = &head;
+    // through createNode and onPush, so StatsPolicy sees the copy's pushes and chunks
     for (Node *it = lls.head; it != nullptr; it = it->next) {
-        // store a deep copy
-        temp.push_back(std::move(it->data));
+        *tail = createNode(it->data);
+        tail = &(*tail)->next;
+        count++;
+        this->onPush(1, count);
     }
+}
+
+template<typename T, bool ThreadLocalPool, typename StatsPolicy>
+void LinkedListStack<T, ThreadLocalPool, StatsPolicy>::deepmove(LinkedListStack &lls) {
+    // empty the stack
+    clear();
 
-    // element-wise push (push from rear to head)
-    for (int i = temp.size() - 1; i >= 0; --i) {
-        push(std::move(temp.at(i)));
+    // steal the nodes together with the chunks holding them
+    if constexpr (!ThreadLocalPool) {
+        ownPool = std::move(lls.ownPool);
     }
+    head = lls.head;
+    count = lls.count;
 
     // reset lls to stable state
-    lls.clear();
+    lls.head = nullptr;
+    lls.count = 0;
 }
 /////////////////////////////////////////////////////////////////
 
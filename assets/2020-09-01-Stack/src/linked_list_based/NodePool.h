@@ -0,0 +1,227 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+using std::vector;
+
+/**
+ * Slab allocator for fixed-size nodes
+ *
+ * Nodes are carved out of contiguous chunks, a chunk is twice as large as the
+ * previous one (capped by MAX_CHUNK_SIZE). Destroyed nodes go to a free list
+ * and are handed out again before the current chunk is touched, so a
+ * push/pop churn never reaches malloc once the pool is warm.
+ *
+ * @tparam Node  the node type, any object type
+ */
+template<typename Node>
+class NodePool {
+public:
+    // constructor
+    explicit NodePool(size_t firstChunkSize = 64);
+
+    /////////////////////////  Big Five  /////////////////////////
+    // 1. destructor
+    virtual ~NodePool();
+
+    // 2. copy constructor (a pool owns its chunks, not copyable)
+    NodePool(const NodePool &) = delete;
+
+    // 3. copy assignment operator= (a pool owns its chunks, not copyable)
+    NodePool& operator=(const NodePool &) = delete;
+
+    // 4. move constructor
+    NodePool(NodePool &&) noexcept;
+
+    // 5. move assignment operator=
+    NodePool& operator=(NodePool &&) noexcept;
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Principle Operations  ///////////////////
+    // construct a node in a free slot
+    template<typename... Args>
+    Node* create(Args&&... args);
+
+    // destroy a node and put its slot on the free list
+    void destroy(Node *node);
+
+    // free every chunk at once
+    // the caller guarantees that no live node needs its destructor to run
+    void release();
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Auxiliary Operations  ///////////////////
+    size_t chunkCount() const;
+
+    size_t slotCount() const;
+    //////////////////////////////////////////////////////////////
+
+private:
+    union Slot {
+        Slot *next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    static constexpr size_t MAX_CHUNK_SIZE = 4096;
+
+    // head of the recycled slots
+    Slot *freeList {nullptr};
+
+    // untouched part of the newest chunk
+    Slot *bumpBegin {nullptr};
+
+    Slot *bumpEnd {nullptr};
+
+    vector<Slot *> chunks;
+
+    size_t firstChunkSize;
+
+    size_t nextChunkSize;
+
+    size_t slots {};
+
+    ///////////////////  Auxiliary Functions  ////////////////////
+    Slot* takeSlot();
+
+    void addChunk();
+
+    void deepmove(NodePool &);
+    //////////////////////////////////////////////////////////////
+};
+
+///////////////////  Function Implementation  ///////////////////
+// constructor
+template<typename Node>
+NodePool<Node>::NodePool(size_t firstChunkSize)
+        : firstChunkSize {std::max<size_t>(firstChunkSize, 1)}, nextChunkSize {std::max<size_t>(firstChunkSize, 1)} {
+}
+
+/////////////////////////  Big Five  /////////////////////////
+// 1. destructor
+template<typename Node>
+NodePool<Node>::~NodePool() {
+    release();
+}
+
+// 4. move constructor
+template<typename Node>
+NodePool<Node>::NodePool(NodePool &&pool) noexcept : firstChunkSize {pool.firstChunkSize}, nextChunkSize {pool.firstChunkSize} {
+    deepmove(pool);
+}
+
+// 5. move assignment operator=
+template<typename Node>
+NodePool<Node>& NodePool<Node>::operator=(NodePool &&pool) noexcept {
+    // check self-assignment
+    if (this == &pool) {
+        return *this;
+    }
+
+    release();
+    deepmove(pool);
+    return *this;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Principle Operations  ///////////////////
+template<typename Node>
+template<typename... Args>
+Node* NodePool<Node>::create(Args&&... args) {
+    Slot *slot = takeSlot();
+    try {
+        return ::new (static_cast<void *>(slot->storage)) Node(std::forward<Args>(args)...);
+    } catch (...) {
+        // give the slot back
+        slot->next = freeList;
+        freeList = slot;
+        throw;
+    }
+}
+
+template<typename Node>
+void NodePool<Node>::destroy(Node *node) {
+    node->~Node();
+    Slot *slot = reinterpret_cast<Slot *>(node);
+    slot->next = freeList;
+    freeList = slot;
+}
+
+template<typename Node>
+void NodePool<Node>::release() {
+    for (Slot *chunk : chunks) {
+        delete[] chunk;
+    }
+    chunks.clear();
+    freeList = nullptr;
+    bumpBegin = nullptr;
+    bumpEnd = nullptr;
+    nextChunkSize = firstChunkSize;
+    slots = 0;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Operations  ///////////////////
+template<typename Node>
+size_t NodePool<Node>::chunkCount() const {
+    return chunks.size();
+}
+
+template<typename Node>
+size_t NodePool<Node>::slotCount() const {
+    return slots;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Functions  ////////////////////
+template<typename Node>
+typename NodePool<Node>::Slot* NodePool<Node>::takeSlot() {
+    // recycled slots first, they are likely still in cache
+    if (freeList != nullptr) {
+        Slot *slot = freeList;
+        freeList = freeList->next;
+        return slot;
+    }
+    if (bumpBegin == bumpEnd) {
+        addChunk();
+    }
+    return bumpBegin++;
+}
+
+template<typename Node>
+void NodePool<Node>::addChunk() {
+    // reserve the bookkeeping entry first so that a failing push_back cannot leak the chunk
+    if (chunks.size() == chunks.capacity()) {
+        chunks.reserve(2 * chunks.size() + 1);
+    }
+    Slot *chunk = new Slot[nextChunkSize];
+    chunks.push_back(chunk);
+    bumpBegin = chunk;
+    bumpEnd = chunk + nextChunkSize;
+    slots += nextChunkSize;
+    nextChunkSize = std::min(2 * nextChunkSize, MAX_CHUNK_SIZE);
+}
+
+template<typename Node>
+void NodePool<Node>::deepmove(NodePool &pool) {
+    // steal all chunks, no node is touched
+    freeList = pool.freeList;
+    bumpBegin = pool.bumpBegin;
+    bumpEnd = pool.bumpEnd;
+    chunks = std::move(pool.chunks);
+    nextChunkSize = pool.nextChunkSize;
+    slots = pool.slots;
+
+    // reset pool to stable state
+    pool.chunks.clear();
+    pool.freeList = nullptr;
+    pool.bumpBegin = nullptr;
+    pool.bumpEnd = nullptr;
+    pool.nextChunkSize = pool.firstChunkSize;
+    pool.slots = 0;
+}
+//////////////////////////////////////////////////////////////
+
+#endif //NODEPOOL_H
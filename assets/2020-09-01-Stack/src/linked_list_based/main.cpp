@@ -1,5 +1,7 @@
 #include <iostream>
 #include <assert.h>
+#include <string>
+#include <vector>
 #include "LinkedListStack.h"
 
 using std::cout;
@@ -64,8 +66,163 @@ void testIntStack() {
     assert(temp2.toString() == "");
 }
 
+void testStringStack() {
+    // test non-trivial elements in pooled nodes
+    LinkedListStack<string> lls1;
+    for (int i = 0; i < 1000; ++i) {
+        lls1.push(std::to_string(i));
+    }
+    assert(lls1.size() == 1000);
+    assert(lls1.top() == "999");
+
+    // test churn, popped nodes are recycled by the pool
+    for (int i = 0; i < 10000; ++i) {
+        lls1.push(string(40, 'x'));
+        assert(lls1.pop() == string(40, 'x'));
+    }
+    assert(lls1.top() == "999");
+
+    // test copy constructor keeps the order
+    LinkedListStack<string> lls2{lls1};
+    assert(lls2.size() == 1000);
+    for (int i = 999; i >= 0; --i) {
+        assert(lls2.pop() == std::to_string(i));
+    }
+    assert(lls2.isEmpty() == true);
+
+    // test clear releases the chunks and the stack is reusable
+    lls1.clear();
+    assert(lls1.isEmpty() == true);
+    lls1.push("again");
+    assert(lls1.top() == "again");
+
+    // test move constructor steals the nodes
+    LinkedListStack<string> lls3{std::move(lls1)};
+    assert(lls1.isEmpty() == true);
+    assert(lls3.pop() == "again");
+}
+
+void testThreadLocalPool() {
+    // test two stacks sharing the pool of this thread
+    LinkedListStack<int, true> lls1;
+    LinkedListStack<int, true> lls2;
+    for (int i = 0; i < 100; ++i) {
+        lls1.push(i);
+        lls2.push(-i);
+    }
+    assert(lls1.pop() == 99);
+    assert(lls2.pop() == -99);
+    lls1.clear();
+    assert(lls2.size() == 99);
+    assert(lls2.top() == -98);
+    // nodes freed by lls1 are reused by lls2
+    for (int i = 0; i < 100; ++i) {
+        lls2.push(i);
+    }
+    assert(lls2.size() == 199);
+    assert(lls2.top() == 99);
+}
+
+void testBulkOperations() {
+    // test pushRange, spliced in one go
+    LinkedListStack<int> lls1;
+    lls1.push(0);
+    std::vector<int> values {1, 2, 3, 4, 5};
+    lls1.pushRange(values.begin(), values.end());
+    assert(lls1.size() == 6);
+    assert(lls1.toString() == "5\n4\n3\n2\n1\n0\n");
+
+    // test popN, output in pop order
+    std::vector<int> out(3);
+    auto end = lls1.popN(3, out.begin());
+    assert(end == out.end());
+    assert((out == std::vector<int> {5, 4, 3}));
+    assert(lls1.size() == 3);
+    assert(lls1.top() == 2);
+
+    // test popN with zero and with everything
+    lls1.popN(0, out.begin());
+    assert(lls1.size() == 3);
+    lls1.popN(3, out.begin());
+    assert(lls1.isEmpty() == true);
+
+    // test popN with more than size
+    bool thrown = false;
+    try {
+        lls1.popN(1, out.begin());
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+
+    // test non-trivial elements
+    LinkedListStack<string> lls2;
+    std::vector<string> words {"a", "b", "c"};
+    lls2.pushRange(words.begin(), words.end());
+    std::vector<string> popped;
+    lls2.popN(2, std::back_inserter(popped));
+    assert((popped == std::vector<string> {"c", "b"}));
+    assert(lls2.top() == "a");
+}
+
+void testStats() {
+    LinkedListStack<int, false, CountingStats> lls;
+    for (int i = 0; i < 100; ++i) {
+        lls.push(i);
+    }
+    std::vector<int> input(50, 7);
+    lls.pushRange(input.begin(), input.end());
+    lls.pop();
+    std::vector<int> out;
+    lls.popN(9, std::back_inserter(out));
+
+    // the pool grows in chunks of 64, 128, ... slots, nothing is copied
+    StackStats st = lls.stats();
+    assert(st.pushes == 150);
+    assert(st.pops == 10);
+    assert(st.growthEvents == 2);
+    assert(st.bytesCopied == 0);
+    assert(st.depth == 140);
+    assert(st.peakDepth == 150);
+    assert(st.footprintBytes >= 150 * sizeof(int));
+
+    // test that a copy reports its own pushes and chunks: 140 nodes need chunks of 64 and 128
+    LinkedListStack<int, false, CountingStats> copied {lls};
+    st = copied.stats();
+    assert(st.pushes == 140);
+    assert(st.growthEvents == 2);
+    assert(st.depth == 140);
+    assert(st.peakDepth == 140);
+
+    // test that a disabled policy still reports the depth
+    LinkedListStack<int> plain;
+    plain.push(1);
+    assert(plain.stats().pushes == 0 && plain.stats().depth == 1);
+}
+
+void testTryOperations() {
+    LinkedListStack<std::string> s;
+    // test tryPop, tryTop on an empty stack: no exception
+    assert(!s.tryPop());
+    assert(!s.tryTop());
+    static_assert(noexcept(s.tryPop()), "tryPop of a nothrow movable T must be noexcept");
+
+    s.push("a");
+    s.push("b");
+    assert(s.tryTop().value() == "b");
+    assert(s.tryPop().value() == "b");
+    assert(s.tryPop().value() == "a");
+    assert(!s.tryPop());
+    assert(s.isEmpty() == true);
+}
+
 int main() {
     testIntStack();
+    testStringStack();
+    testThreadLocalPool();
+    testBulkOperations();
+    testStats();
+    testTryOperations();
 
     return 0;
 }
\ No newline at end of file
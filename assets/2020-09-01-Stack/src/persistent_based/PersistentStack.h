@@ -0,0 +1,252 @@
+#ifndef PERSISTENT_STACK_H
+#define PERSISTENT_STACK_H
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+using std::string;
+
+/**
+ * Persistent (immutable) linked list based Stack
+ *
+ * A version never changes: push() and pop() return a new version that
+ * shares its tail with the old one, so copying a stack is O(1) and every
+ * fork of a stack only pays for the nodes pushed after the fork.
+ *
+ * Nodes are reference counted. Releasing a version frees its nodes down to
+ * the first one still used by another version, iteratively, so dropping a
+ * long stack does not recurse.
+ *
+ *     PersistentStack<int> a;
+ *     PersistentStack<int> b = a.push(1).push(2);   // 2 1
+ *     PersistentStack<int> c = b.pop().push(3);     // 3 1, shares node 1 with b
+ *
+ * @tparam T       generic type
+ * @tparam ATOMIC  false: plain reference counts, a version and all its copies
+ *                        stay on one thread
+ *                 true:  atomic reference counts, versions may be copied and
+ *                        dropped on any thread (the elements are immutable)
+ */
+template<typename T, bool ATOMIC = false>
+class PersistentStack {
+public:
+    // constructor, the empty stack
+    PersistentStack();
+
+    /////////////////////////  Big Five  /////////////////////////
+    // 1. destructor
+    virtual ~PersistentStack();
+
+    // 2. copy constructor, O(1)
+    PersistentStack(const PersistentStack &);
+
+    // 3. copy assignment operator=, O(1) plus the nodes released
+    PersistentStack& operator=(const PersistentStack &);
+
+    // 4. move constructor
+    PersistentStack(PersistentStack &&) noexcept;
+
+    // 5. move assignment operator=
+    PersistentStack& operator=(PersistentStack &&) noexcept;
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Principle Operations  ///////////////////
+    // a new version with e on top
+    PersistentStack push(T e) const;
+
+    // a new version without the top element
+    PersistentStack pop() const;
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Auxiliary Operations  ///////////////////
+    bool isEmpty() const;
+
+    size_t size() const;
+
+    const T& top() const;
+
+    string toString() const;
+
+    // whether both versions are the same list, i.e. one was copied from the other
+    bool sharesWith(const PersistentStack &ps) const;
+    //////////////////////////////////////////////////////////////
+
+private:
+    using RefCount = typename std::conditional<ATOMIC, std::atomic<size_t>, size_t>::type;
+
+    struct Node {
+        const T data;
+        Node *const next;
+        // number of elements from this node down
+        const size_t depth;
+        RefCount refs;
+
+        // Node constructor, takes over one reference to next
+        Node(T data, Node *next) : data {std::move(data)}, next {next},
+                                   depth {next != nullptr ? next->depth + 1 : 1}, refs {1} {
+        }
+    };
+
+    Node *head {nullptr};
+
+    // takes over one reference to head
+    explicit PersistentStack(Node *head);
+
+    ///////////////////  Auxiliary Functions  ////////////////////
+    static Node* retain(Node *node);
+
+    static void release(Node *node);
+    //////////////////////////////////////////////////////////////
+};
+
+///////////////////  Function Implementation  ///////////////////
+// constructor
+template<typename T, bool ATOMIC>
+PersistentStack<T, ATOMIC>::PersistentStack() = default;
+
+template<typename T, bool ATOMIC>
+PersistentStack<T, ATOMIC>::PersistentStack(Node *head) : head {head} {
+}
+
+/////////////////////////  Big Five  /////////////////////////
+// 1. destructor
+template<typename T, bool ATOMIC>
+PersistentStack<T, ATOMIC>::~PersistentStack() {
+    release(head);
+}
+
+// 2. copy constructor
+template<typename T, bool ATOMIC>
+PersistentStack<T, ATOMIC>::PersistentStack(const PersistentStack &ps) : head {retain(ps.head)} {
+}
+
+// 3. copy assignment operator=
+template<typename T, bool ATOMIC>
+PersistentStack<T, ATOMIC>& PersistentStack<T, ATOMIC>::operator=(const PersistentStack &ps) {
+    // retain first, this also makes self-assignment safe
+    Node *old = head;
+    head = retain(ps.head);
+    release(old);
+    return *this;
+}
+
+// 4. move constructor
+template<typename T, bool ATOMIC>
+PersistentStack<T, ATOMIC>::PersistentStack(PersistentStack &&ps) noexcept : head {ps.head} {
+    ps.head = nullptr;
+}
+
+// 5. move assignment operator=
+template<typename T, bool ATOMIC>
+PersistentStack<T, ATOMIC>& PersistentStack<T, ATOMIC>::operator=(PersistentStack &&ps) noexcept {
+    // check self-assignment
+    if (this == &ps) {
+        return *this;
+    }
+
+    release(head);
+    head = ps.head;
+    ps.head = nullptr;
+    return *this;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Principle Operations  ///////////////////
+template<typename T, bool ATOMIC>
+PersistentStack<T, ATOMIC> PersistentStack<T, ATOMIC>::push(T e) const {
+    // the new node shares this version's list
+    Node *tail = retain(head);
+    try {
+        return PersistentStack(new Node(std::move(e), tail));
+    } catch (...) {
+        release(tail);
+        throw;
+    }
+}
+
+template<typename T, bool ATOMIC>
+PersistentStack<T, ATOMIC> PersistentStack<T, ATOMIC>::pop() const {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return PersistentStack(retain(head->next));
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Operations  ///////////////////
+template<typename T, bool ATOMIC>
+bool PersistentStack<T, ATOMIC>::isEmpty() const {
+    return head == nullptr;
+}
+
+template<typename T, bool ATOMIC>
+size_t PersistentStack<T, ATOMIC>::size() const {
+    return head != nullptr ? head->depth : 0;
+}
+
+template<typename T, bool ATOMIC>
+const T& PersistentStack<T, ATOMIC>::top() const {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return head->data;
+}
+
+template<typename T, bool ATOMIC>
+string PersistentStack<T, ATOMIC>::toString() const {
+    if (isEmpty()) {
+        return "";
+    }
+
+    string ret;
+    for (Node *it = head; it != nullptr; it = it->next) {
+        ret += std::to_string(it->data) + "\n";
+    }
+    return ret;
+}
+
+template<typename T, bool ATOMIC>
+bool PersistentStack<T, ATOMIC>::sharesWith(const PersistentStack &ps) const {
+    return head == ps.head;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Functions  ////////////////////
+template<typename T, bool ATOMIC>
+typename PersistentStack<T, ATOMIC>::Node* PersistentStack<T, ATOMIC>::retain(Node *node) {
+    if (node != nullptr) {
+        if constexpr (ATOMIC) {
+            // a new reference is made from an existing one, no ordering needed
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            node->refs++;
+        }
+    }
+    return node;
+}
+
+template<typename T, bool ATOMIC>
+void PersistentStack<T, ATOMIC>::release(Node *node) {
+    // free down to the first node another version still uses
+    while (node != nullptr) {
+        if constexpr (ATOMIC) {
+            // acq_rel: the last owner must see every other owner's accesses
+            if (node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+        } else {
+            if (--node->refs != 0) {
+                return;
+            }
+        }
+        Node *next = node->next;
+        delete node;
+        node = next;
+    }
+}
+//////////////////////////////////////////////////////////////
+
+#endif //PERSISTENT_STACK_H
@@ -0,0 +1,131 @@
+#include <iostream>
+#include <assert.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include "PersistentStack.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::thread;
+
+void testIntStack() {
+    // test constructor
+    PersistentStack<int> empty;
+    assert(empty.isEmpty() == true);
+    assert(empty.size() == 0);
+    assert(empty.toString() == "");
+
+    // test push: every version stays valid
+    PersistentStack<int> one = empty.push(10);
+    PersistentStack<int> two = one.push(20);
+    PersistentStack<int> three = two.push(30);
+    assert(empty.isEmpty() == true);
+    assert(one.toString() == "10\n");
+    assert(two.toString() == "20\n10\n");
+    assert(three.toString() == "30\n20\n10\n");
+    assert(three.size() == 3);
+    assert(three.top() == 30);
+
+    // test pop shares the tail
+    PersistentStack<int> popped = three.pop();
+    assert(popped.sharesWith(two) == true);
+    assert(popped.top() == 20);
+    assert(three.size() == 3);
+
+    // test a fork of the same base
+    PersistentStack<int> fork = two.pop().push(40);
+    assert(fork.toString() == "40\n10\n");
+    assert(fork.pop().sharesWith(one) == true);
+    assert(two.toString() == "20\n10\n");
+
+    // test copy and move are O(1): the same list
+    PersistentStack<int> copy {three};
+    assert(copy.sharesWith(three) == true);
+    PersistentStack<int> moved {std::move(copy)};
+    assert(moved.sharesWith(three) == true);
+    assert(copy.isEmpty() == true);
+
+    // test copy and move assignment, self-assignment included
+    copy = fork;
+    copy = copy;
+    assert(copy.toString() == "40\n10\n");
+    moved = std::move(copy);
+    assert(moved.toString() == "40\n10\n");
+
+    // test pop and top on an empty stack
+    bool thrown = false;
+    try {
+        empty.pop();
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+    thrown = false;
+    try {
+        empty.top();
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+}
+
+void testStringStack() {
+    PersistentStack<std::string> base;
+    for (int i = 0; i < 100; ++i) {
+        base = base.push(std::string(40, static_cast<char>('a' + i % 26)));
+    }
+
+    // undo history: every version is kept, each costs one node
+    vector<PersistentStack<std::string>> history {base};
+    for (int i = 0; i < 50; ++i) {
+        history.push_back(history.back().pop().push("edit " + std::to_string(i)));
+    }
+    assert(history.back().top() == "edit 49");
+    assert(history.back().size() == 100);
+    assert(history.front().top() == std::string(40, 'v'));
+}
+
+void testLongStack() {
+    // releasing a long list must not recurse
+    PersistentStack<int> ps;
+    for (int i = 0; i < 1000000; ++i) {
+        ps = ps.push(i);
+    }
+    assert(ps.size() == 1000000);
+}
+
+void testAtomicSharing() {
+    // versions shared by many threads, the last one to drop a node frees it
+    PersistentStack<int, true> base;
+    for (int i = 0; i < 1000; ++i) {
+        base = base.push(i);
+    }
+
+    vector<thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([base, t]() {
+            PersistentStack<int, true> mine = base;
+            for (int i = 0; i < 10000; ++i) {
+                PersistentStack<int, true> fork = mine.pop().push(t);
+                assert(fork.size() == 1000);
+                mine = i % 2 == 0 ? fork : base;
+            }
+        });
+    }
+    base = PersistentStack<int, true>();
+    for (thread &t : threads) {
+        t.join();
+    }
+    assert(base.isEmpty() == true);
+}
+
+int main() {
+    testIntStack();
+    testStringStack();
+    testLongStack();
+    testAtomicSharing();
+
+    return 0;
+}
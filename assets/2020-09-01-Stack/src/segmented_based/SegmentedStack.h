@@ -0,0 +1,369 @@
+#ifndef SEGMENTED_STACK_H
+#define SEGMENTED_STACK_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+
+/**
+ * Segmented (unrolled) Stack
+ *
+ * A linked list of fixed-size array segments: elements inside a segment are
+ * contiguous like in ArrayStack, and a full segment is never copied, a new
+ * one is linked on top instead. Growth is O(1) even for multi-GB stacks and
+ * the address of an element stays valid until it is popped.
+ *
+ * The last emptied segment is kept as a spare, so a stack oscillating around
+ * a segment boundary does not allocate and free a segment every time.
+ *
+ * @tparam T             generic type
+ *                       assuming that T is move constructible or copy constructible
+ * @tparam SEGMENT_SIZE  elements per segment, about 64 KiB per segment by default
+ */
+template<typename T, size_t SEGMENT_SIZE = (65536 / sizeof(T) > 0 ? 65536 / sizeof(T) : 1)>
+class SegmentedStack {
+    static_assert(SEGMENT_SIZE > 0, "SegmentedStack needs a positive segment size.");
+
+public:
+    // constructor
+    SegmentedStack();
+
+    /////////////////////////  Big Five  /////////////////////////
+    // 1. destructor
+    virtual ~SegmentedStack();
+
+    // 2. copy constructor
+    SegmentedStack(const SegmentedStack &);
+
+    // 3. copy assignment operator=
+    SegmentedStack& operator=(const SegmentedStack &);
+
+    // 4. move constructor
+    SegmentedStack(SegmentedStack &&) noexcept;
+
+    // 5. move assignment operator=
+    SegmentedStack& operator=(SegmentedStack &&) noexcept;
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Principle Operations  ///////////////////
+    void push(const T &e);
+
+    void push(T &&e);
+
+    // construct the new top element in place from args
+    template<typename... Args>
+    T& emplace(Args&&... args);
+
+    // move the top element out
+    T pop();
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Auxiliary Operations  ///////////////////
+    bool isEmpty() const;
+
+    size_t size() const;
+
+    T& top();
+
+    const T& top() const;
+
+    // destroys every element, keeps one segment as the spare
+    void clear();
+
+    string toString() const;
+
+    // number of segments held, the spare included
+    size_t segmentCount() const;
+
+    // release the spare segment
+    void shrink_to_fit();
+    //////////////////////////////////////////////////////////////
+
+private:
+    struct Segment {
+        // the segment below, nullptr for the bottom segment
+        Segment *prev;
+
+        alignas(T) unsigned char slots[SEGMENT_SIZE * sizeof(T)];
+
+        T* at(size_t i) {
+            return reinterpret_cast<T *>(slots) + i;
+        }
+
+        const T* at(size_t i) const {
+            return reinterpret_cast<const T *>(slots) + i;
+        }
+    };
+
+    // the segment holding the top element
+    Segment *tail {nullptr};
+
+    // number of elements in tail
+    size_t used {};
+
+    // an empty segment ready to be linked
+    Segment *spare {nullptr};
+
+    size_t count {};
+
+    size_t segments {};
+
+    ///////////////////  Auxiliary Functions  ////////////////////
+    void linkSegment();
+
+    void unlinkSegment();
+
+    void destroyElements();
+
+    void deepcopy(const SegmentedStack &);
+
+    void deepmove(SegmentedStack &);
+    //////////////////////////////////////////////////////////////
+};
+
+///////////////////  Function Implementation  ///////////////////
+// constructor
+template<typename T, size_t SEGMENT_SIZE>
+SegmentedStack<T, SEGMENT_SIZE>::SegmentedStack() = default;
+
+/////////////////////////  Big Five  /////////////////////////
+// 1. destructor
+template<typename T, size_t SEGMENT_SIZE>
+SegmentedStack<T, SEGMENT_SIZE>::~SegmentedStack() {
+    destroyElements();
+    shrink_to_fit();
+}
+
+// 2. copy constructor
+template<typename T, size_t SEGMENT_SIZE>
+SegmentedStack<T, SEGMENT_SIZE>::SegmentedStack(const SegmentedStack &ss) {
+    deepcopy(ss);
+}
+
+// 3. copy assignment operator=
+template<typename T, size_t SEGMENT_SIZE>
+SegmentedStack<T, SEGMENT_SIZE>& SegmentedStack<T, SEGMENT_SIZE>::operator=(const SegmentedStack &ss) {
+    // check self-assignment
+    if (this == &ss) {
+        return *this;
+    }
+
+    deepcopy(ss);
+    return *this;
+}
+
+// 4. move constructor
+template<typename T, size_t SEGMENT_SIZE>
+SegmentedStack<T, SEGMENT_SIZE>::SegmentedStack(SegmentedStack &&ss) noexcept {
+    deepmove(ss);
+}
+
+// 5. move assignment operator=
+template<typename T, size_t SEGMENT_SIZE>
+SegmentedStack<T, SEGMENT_SIZE>& SegmentedStack<T, SEGMENT_SIZE>::operator=(SegmentedStack &&ss) noexcept {
+    // check self-assignment
+    if (this == &ss) {
+        return *this;
+    }
+
+    deepmove(ss);
+    return *this;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Principle Operations  ///////////////////
+template<typename T, size_t SEGMENT_SIZE>
+void SegmentedStack<T, SEGMENT_SIZE>::push(const T &e) {
+    emplace(e);
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+void SegmentedStack<T, SEGMENT_SIZE>::push(T &&e) {
+    emplace(std::move(e));
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+template<typename... Args>
+T& SegmentedStack<T, SEGMENT_SIZE>::emplace(Args&&... args) {
+    if (tail == nullptr || used == SEGMENT_SIZE) {
+        // link a new segment on top, nothing is copied
+        linkSegment();
+    }
+    try {
+        ::new (static_cast<void *>(tail->at(used))) T(std::forward<Args>(args)...);
+    } catch (...) {
+        if (used == 0) {
+            // give the fresh segment back
+            unlinkSegment();
+        }
+        throw;
+    }
+    used++;
+    count++;
+    return *tail->at(used - 1);
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+T SegmentedStack<T, SEGMENT_SIZE>::pop() {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    T *slot = tail->at(used - 1);
+    T ret {std::move(*slot)};
+    slot->~T();
+    used--;
+    count--;
+    if (used == 0) {
+        unlinkSegment();
+    }
+    return ret;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Operations  ///////////////////
+template<typename T, size_t SEGMENT_SIZE>
+bool SegmentedStack<T, SEGMENT_SIZE>::isEmpty() const {
+    return count == 0;
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+size_t SegmentedStack<T, SEGMENT_SIZE>::size() const {
+    return count;
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+T& SegmentedStack<T, SEGMENT_SIZE>::top() {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return *tail->at(used - 1);
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+const T& SegmentedStack<T, SEGMENT_SIZE>::top() const {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return *tail->at(used - 1);
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+void SegmentedStack<T, SEGMENT_SIZE>::clear() {
+    destroyElements();
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+string SegmentedStack<T, SEGMENT_SIZE>::toString() const {
+    if (isEmpty()) {
+        return "";
+    }
+
+    string ret;
+    size_t n = used;
+    for (const Segment *seg = tail; seg != nullptr; seg = seg->prev, n = SEGMENT_SIZE) {
+        for (size_t i = n; i-- > 0; ) {
+            ret += std::to_string(*seg->at(i)) + "\n";
+        }
+    }
+    return ret;
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+size_t SegmentedStack<T, SEGMENT_SIZE>::segmentCount() const {
+    return segments;
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+void SegmentedStack<T, SEGMENT_SIZE>::shrink_to_fit() {
+    if (spare != nullptr) {
+        delete spare;
+        spare = nullptr;
+        segments--;
+    }
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Functions  ////////////////////
+template<typename T, size_t SEGMENT_SIZE>
+void SegmentedStack<T, SEGMENT_SIZE>::linkSegment() {
+    Segment *seg = spare;
+    if (seg != nullptr) {
+        spare = nullptr;
+    } else {
+        seg = new Segment;
+        segments++;
+    }
+    seg->prev = tail;
+    tail = seg;
+    used = 0;
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+void SegmentedStack<T, SEGMENT_SIZE>::unlinkSegment() {
+    // tail is empty: keep it as the spare, the previous spare is freed
+    Segment *seg = tail;
+    tail = tail->prev;
+    used = tail != nullptr ? SEGMENT_SIZE : 0;
+    shrink_to_fit();
+    spare = seg;
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+void SegmentedStack<T, SEGMENT_SIZE>::destroyElements() {
+    // destroy from top to bottom, the reverse order of construction
+    while (tail != nullptr) {
+        for (size_t i = used; i-- > 0; ) {
+            tail->at(i)->~T();
+        }
+        count -= used;
+        used = 0;
+        unlinkSegment();
+    }
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+void SegmentedStack<T, SEGMENT_SIZE>::deepcopy(const SegmentedStack &ss) {
+    // empty the stack
+    clear();
+
+    // segments are linked top to bottom, collect them to copy bottom up
+    vector<const Segment *> order;
+    for (const Segment *seg = ss.tail; seg != nullptr; seg = seg->prev) {
+        order.push_back(seg);
+    }
+    for (size_t s = order.size(); s-- > 0; ) {
+        size_t n = s == 0 ? ss.used : SEGMENT_SIZE;
+        for (size_t i = 0; i < n; ++i) {
+            push(*order[s]->at(i));
+        }
+    }
+}
+
+template<typename T, size_t SEGMENT_SIZE>
+void SegmentedStack<T, SEGMENT_SIZE>::deepmove(SegmentedStack &ss) {
+    // empty the stack
+    destroyElements();
+    shrink_to_fit();
+
+    // steal the segments, no element is touched
+    tail = ss.tail;
+    used = ss.used;
+    spare = ss.spare;
+    count = ss.count;
+    segments = ss.segments;
+
+    // reset ss to stable state
+    ss.tail = nullptr;
+    ss.used = 0;
+    ss.spare = nullptr;
+    ss.count = 0;
+    ss.segments = 0;
+}
+//////////////////////////////////////////////////////////////
+
+#endif //SEGMENTED_STACK_H
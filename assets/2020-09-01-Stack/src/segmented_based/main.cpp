@@ -0,0 +1,94 @@
+#include <iostream>
+#include <assert.h>
+#include <string>
+#include "SegmentedStack.h"
+
+using std::cout;
+using std::endl;
+
+void testIntStack() {
+    // test constructor
+    SegmentedStack<int, 4> ss1;
+    assert(ss1.toString() == "");
+    assert(ss1.segmentCount() == 0);
+
+    // test push, top, toString across segment boundaries
+    for (int i = 1; i <= 10; ++i) {
+        ss1.push(i * 10);
+    }
+    assert(ss1.top() == 100);
+    assert(ss1.size() == 10);
+    assert(ss1.segmentCount() == 3);
+    assert(ss1.toString() == "100\n90\n80\n70\n60\n50\n40\n30\n20\n10\n");
+
+    // test pop
+    assert(ss1.pop() == 100);
+    assert(ss1.pop() == 90);
+    assert(ss1.top() == 80);
+    // the emptied segment is kept as the spare
+    assert(ss1.segmentCount() == 3);
+
+    // test copy constructor, copy assignment operator
+    SegmentedStack<int, 4> ss2{ss1};
+    assert(ss2.toString() == ss1.toString());
+    ss2.pop();
+    ss1 = ss2;
+    assert(ss1.toString() == "70\n60\n50\n40\n30\n20\n10\n");
+
+    // test move constructor, move assignment operator
+    SegmentedStack<int, 4> ss3{std::move(ss2)};
+    assert(ss2.isEmpty() == true);
+    assert(ss2.toString() == "");
+    assert(ss3.size() == 7);
+    ss2 = std::move(ss3);
+    assert(ss2.top() == 70);
+    assert(ss3.isEmpty() == true);
+
+    // test clear, shrink_to_fit
+    ss2.clear();
+    assert(ss2.isEmpty() == true);
+    assert(ss2.segmentCount() == 1);
+    ss2.shrink_to_fit();
+    assert(ss2.segmentCount() == 0);
+}
+
+void testBoundaryOscillation() {
+    // push/pop around a segment boundary reuses the spare segment
+    SegmentedStack<int, 4> ss;
+    for (int i = 0; i < 4; ++i) {
+        ss.push(i);
+    }
+    assert(ss.segmentCount() == 1);
+    for (int i = 0; i < 1000; ++i) {
+        ss.push(i);
+        assert(ss.segmentCount() == 2);
+        ss.pop();
+        assert(ss.segmentCount() == 2);
+    }
+    assert(ss.top() == 3);
+}
+
+void testStableAddresses() {
+    // growth links segments, elements are never moved
+    SegmentedStack<std::string, 8> ss;
+    ss.push("bottom");
+    std::string *bottom = &ss.top();
+    for (int i = 0; i < 1000; ++i) {
+        ss.emplace(40, static_cast<char>('a' + i % 26));
+    }
+    assert(*bottom == "bottom");
+    for (int i = 0; i < 1000; ++i) {
+        ss.pop();
+    }
+    assert(&ss.top() == bottom);
+    assert(ss.pop() == "bottom");
+    assert(ss.isEmpty() == true);
+}
+
+int main() {
+    testIntStack();
+    testBoundaryOscillation();
+    testStableAddresses();
+
+    return 0;
+}
@@ -0,0 +1,437 @@
+#ifndef STATIC_ARRAY_STACK_H
+#define STATIC_ARRAY_STACK_H
+
+#include <string>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
+
+using std::string;
+
+/**
+ * Storage of StaticArrayStack, selected by the element type
+ *
+ * TRIVIAL (trivial T, no spilling): a plain T array, so the whole stack is a
+ * literal type and can be used in constant expressions. The slots are value
+ * initialized once when the stack is created.
+ *
+ * otherwise: raw inline storage with placement construction, plus an optional
+ * heap buffer once the stack spills past N.
+ */
+template<typename T, size_t N, bool SPILL,
+         bool TRIVIAL = std::is_trivial<T>::value && !SPILL>
+class StaticArrayStackStorage;
+
+template<typename T, size_t N, bool SPILL>
+class StaticArrayStackStorage<T, N, SPILL, true> {
+protected:
+    T slots[N] {};
+
+    size_t count {};
+
+    constexpr T* data() {
+        return slots;
+    }
+
+    constexpr const T* data() const {
+        return slots;
+    }
+
+    constexpr size_t currentCapacity() const {
+        return N;
+    }
+
+    template<typename... Args>
+    constexpr void construct(size_t i, Args&&... args) {
+        slots[i] = T(std::forward<Args>(args)...);
+    }
+
+    constexpr void destroy(size_t) {
+    }
+
+    void spill(size_t) {
+        // never called, TRIVIAL implies !SPILL
+    }
+};
+
+template<typename T, size_t N, bool SPILL>
+class StaticArrayStackStorage<T, N, SPILL, false> {
+protected:
+    StaticArrayStackStorage() = default;
+
+    /////////////////////////  Big Five  /////////////////////////
+    // 1. destructor
+    ~StaticArrayStackStorage() {
+        destroyAll();
+        deallocate();
+    }
+
+    // 2. copy constructor
+    StaticArrayStackStorage(const StaticArrayStackStorage &s) {
+        deepcopy(s);
+    }
+
+    // 3. copy assignment operator=
+    StaticArrayStackStorage& operator=(const StaticArrayStackStorage &s) {
+        // check self-assignment
+        if (this == &s) {
+            return *this;
+        }
+
+        destroyAll();
+        deepcopy(s);
+        return *this;
+    }
+
+    // 4. move constructor
+    StaticArrayStackStorage(StaticArrayStackStorage &&s) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        deepmove(s);
+    }
+
+    // 5. move assignment operator=
+    StaticArrayStackStorage& operator=(StaticArrayStackStorage &&s) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        // check self-assignment
+        if (this == &s) {
+            return *this;
+        }
+
+        destroyAll();
+        deallocate();
+        deepmove(s);
+        return *this;
+    }
+    //////////////////////////////////////////////////////////////
+
+    alignas(T) unsigned char inlineSlots[N * sizeof(T)];
+
+    // only non-null once spilled
+    T *heap {nullptr};
+
+    size_t heapCapacity {};
+
+    size_t count {};
+
+    T* data() {
+        return heap != nullptr ? heap : reinterpret_cast<T *>(inlineSlots);
+    }
+
+    const T* data() const {
+        return heap != nullptr ? heap : reinterpret_cast<const T *>(inlineSlots);
+    }
+
+    size_t currentCapacity() const {
+        return heap != nullptr ? heapCapacity : N;
+    }
+
+    template<typename... Args>
+    void construct(size_t i, Args&&... args) {
+        ::new (static_cast<void *>(data() + i)) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(size_t i) {
+        data()[i].~T();
+    }
+
+    // relocate every element to a heap buffer of newCapacity
+    void spill(size_t newCapacity) {
+        T *temp = std::allocator<T>{}.allocate(newCapacity);
+        try {
+            relocateInto(temp);
+        } catch (...) {
+            std::allocator<T>{}.deallocate(temp, newCapacity);
+            throw;
+        }
+        deallocate();
+        heap = temp;
+        heapCapacity = newCapacity;
+    }
+
+    // spill and construct one more element from args on top; args may refer to an element,
+    // so it is built before the old ones are relocated and destroyed
+    template<typename... Args>
+    void spillEmplace(size_t newCapacity, Args&&... args) {
+        T *temp = std::allocator<T>{}.allocate(newCapacity);
+        try {
+            ::new (static_cast<void *>(temp + count)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            std::allocator<T>{}.deallocate(temp, newCapacity);
+            throw;
+        }
+        try {
+            relocateInto(temp);
+        } catch (...) {
+            temp[count].~T();
+            std::allocator<T>{}.deallocate(temp, newCapacity);
+            throw;
+        }
+        deallocate();
+        heap = temp;
+        heapCapacity = newCapacity;
+        count++;
+    }
+
+private:
+    // move the elements to temp and destroy the old ones; on a throw temp holds none of them
+    void relocateInto(T *temp) {
+        T *old = data();
+        size_t i = 0;
+        try {
+            for (; i < count; ++i) {
+                ::new (static_cast<void *>(temp + i)) T(std::move_if_noexcept(old[i]));
+            }
+        } catch (...) {
+            std::destroy(temp, temp + i);
+            throw;
+        }
+        std::destroy(old, old + count);
+    }
+
+    void destroyAll() {
+        // destroy from top to bottom, the reverse order of construction
+        while (count > 0) {
+            destroy(--count);
+        }
+    }
+
+    void deallocate() {
+        if (heap != nullptr) {
+            std::allocator<T>{}.deallocate(heap, heapCapacity);
+            heap = nullptr;
+            heapCapacity = 0;
+        }
+    }
+
+    void deepcopy(const StaticArrayStackStorage &s) {
+        if (s.count > currentCapacity()) {
+            // only reachable with SPILL, the source has spilled
+            spill(s.heapCapacity);
+        }
+        std::uninitialized_copy(s.data(), s.data() + s.count, data());
+        count = s.count;
+    }
+
+    void deepmove(StaticArrayStackStorage &s) {
+        if (s.heap != nullptr) {
+            // steal the heap buffer, no element is touched
+            heap = s.heap;
+            heapCapacity = s.heapCapacity;
+            count = s.count;
+            s.heap = nullptr;
+            s.heapCapacity = 0;
+            s.count = 0;
+            return;
+        }
+        // inline elements have to be moved one by one
+        std::uninitialized_move(s.data(), s.data() + s.count, data());
+        count = s.count;
+        s.destroyAll();
+    }
+};
+
+/**
+ * Fixed capacity array based Stack with inline storage
+ *
+ * Same interface as ArrayStack, but the N slots live inside the object, so a
+ * stack on the call stack never touches the heap. A push on a full stack
+ * throws, unless SPILL is set: then the elements move to a heap buffer that
+ * doubles from there on, small-vector style.
+ *
+ * For trivial T without SPILL every operation except toString() is constexpr.
+ *
+ * @tparam T      generic type
+ * @tparam N      inline capacity
+ * @tparam SPILL  whether to spill to the heap past N
+ */
+template<typename T, size_t N, bool SPILL = false>
+class StaticArrayStack : private StaticArrayStackStorage<T, N, SPILL> {
+    static_assert(N > 0, "StaticArrayStack needs a positive capacity.");
+
+public:
+    // constructor
+    constexpr StaticArrayStack() = default;
+
+    /////////////////////////  Big Five  /////////////////////////
+    // all five are inherited from the storage; the destructor is not virtual,
+    // a virtual destructor would stop the trivial stack from being a literal type
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Principle Operations  ///////////////////
+    constexpr void push(const T &e);
+
+    constexpr void push(T &&e);
+
+    // construct the new top element in place from args
+    template<typename... Args>
+    constexpr T& emplace(Args&&... args);
+
+    // move the top element out
+    constexpr T pop();
+
+    // push [first, last) in order, *first ends up deepest
+    template<typename InputIt>
+    constexpr void pushRange(InputIt first, InputIt last);
+
+    // pop n elements into out in pop order (top first), returns the end of the output
+    template<typename OutputIt>
+    constexpr OutputIt popN(size_t n, OutputIt out);
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Auxiliary Operations  ///////////////////
+    constexpr bool isEmpty() const;
+
+    constexpr bool isFull() const;
+
+    constexpr size_t size() const;
+
+    constexpr T& top();
+
+    constexpr const T& top() const;
+
+    constexpr void clear();
+
+    string toString() const;
+
+    constexpr size_t getCapacity() const;
+
+    // whether the elements have moved to the heap
+    constexpr bool isSpilled() const;
+    //////////////////////////////////////////////////////////////
+
+private:
+    using Storage = StaticArrayStackStorage<T, N, SPILL>;
+};
+
+///////////////////  Function Implementation  ///////////////////
+
+///////////////////  Principle Operations  ///////////////////
+template<typename T, size_t N, bool SPILL>
+constexpr void StaticArrayStack<T, N, SPILL>::push(const T &e) {
+    emplace(e);
+}
+
+template<typename T, size_t N, bool SPILL>
+constexpr void StaticArrayStack<T, N, SPILL>::push(T &&e) {
+    emplace(std::move(e));
+}
+
+template<typename T, size_t N, bool SPILL>
+template<typename... Args>
+constexpr T& StaticArrayStack<T, N, SPILL>::emplace(Args&&... args) {
+    if (isFull()) {
+        if constexpr (SPILL) {
+            // double the capacity on the heap, the new element is built there first
+            this->spillEmplace(2 * this->currentCapacity(), std::forward<Args>(args)...);
+            return this->data()[this->count - 1];
+        } else {
+            throw std::runtime_error("Stack is full.");
+        }
+    }
+    // count is only bumped once construction succeeded
+    this->construct(this->count, std::forward<Args>(args)...);
+    this->count++;
+    return this->data()[this->count - 1];
+}
+
+template<typename T, size_t N, bool SPILL>
+constexpr T StaticArrayStack<T, N, SPILL>::pop() {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    T ret {std::move(this->data()[this->count - 1])};
+    this->destroy(this->count - 1);
+    this->count--;
+    return ret;
+}
+
+template<typename T, size_t N, bool SPILL>
+template<typename InputIt>
+constexpr void StaticArrayStack<T, N, SPILL>::pushRange(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+        emplace(*first);
+    }
+}
+
+template<typename T, size_t N, bool SPILL>
+template<typename OutputIt>
+constexpr OutputIt StaticArrayStack<T, N, SPILL>::popN(size_t n, OutputIt out) {
+    if (n > this->count) {
+        throw std::runtime_error("Stack has fewer elements than requested.");
+    }
+    for (size_t i = 0; i < n; ++i, ++out) {
+        *out = pop();
+    }
+    return out;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Operations  ///////////////////
+template<typename T, size_t N, bool SPILL>
+constexpr bool StaticArrayStack<T, N, SPILL>::isEmpty() const {
+    return this->count == 0;
+}
+
+template<typename T, size_t N, bool SPILL>
+constexpr bool StaticArrayStack<T, N, SPILL>::isFull() const {
+    return this->count == this->currentCapacity();
+}
+
+template<typename T, size_t N, bool SPILL>
+constexpr size_t StaticArrayStack<T, N, SPILL>::size() const {
+    return this->count;
+}
+
+template<typename T, size_t N, bool SPILL>
+constexpr T& StaticArrayStack<T, N, SPILL>::top() {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return this->data()[this->count - 1];
+}
+
+template<typename T, size_t N, bool SPILL>
+constexpr const T& StaticArrayStack<T, N, SPILL>::top() const {
+    if (isEmpty()) {
+        throw std::runtime_error("Stack is empty.");
+    }
+    return this->data()[this->count - 1];
+}
+
+template<typename T, size_t N, bool SPILL>
+constexpr void StaticArrayStack<T, N, SPILL>::clear() {
+    while (this->count > 0) {
+        this->destroy(--this->count);
+    }
+}
+
+template<typename T, size_t N, bool SPILL>
+string StaticArrayStack<T, N, SPILL>::toString() const {
+    if (isEmpty()) {
+        return "";
+    }
+
+    string ret;
+    for (size_t i = this->count; i-- > 0; ) {
+        ret += std::to_string(this->data()[i]) + "\n";
+    }
+    return ret;
+}
+
+template<typename T, size_t N, bool SPILL>
+constexpr size_t StaticArrayStack<T, N, SPILL>::getCapacity() const {
+    return this->currentCapacity();
+}
+
+template<typename T, size_t N, bool SPILL>
+constexpr bool StaticArrayStack<T, N, SPILL>::isSpilled() const {
+    if constexpr (SPILL) {
+        return this->heap != nullptr;
+    } else {
+        return false;
+    }
+}
+//////////////////////////////////////////////////////////////
+
+#endif //STATIC_ARRAY_STACK_H
@@ -0,0 +1,146 @@
+#include <iostream>
+#include <assert.h>
+#include <string>
+#include <vector>
+#include "StaticArrayStack.h"
+
+using std::cout;
+using std::endl;
+
+// evaluated by the compiler, only possible for trivial T without spilling
+constexpr int evaluateAtCompileTime() {
+    StaticArrayStack<int, 8> sas;
+    sas.push(1);
+    sas.push(2);
+    sas.emplace(3);
+    int sum = sas.pop();
+    sum += sas.top() * 10;
+    return sum + static_cast<int>(sas.size()) * 100;
+}
+
+void testIntStack() {
+    // test constexpr use
+    static_assert(evaluateAtCompileTime() == 223, "constexpr push/pop");
+
+    // test constructor
+    StaticArrayStack<int, 4> sas;
+    assert(sas.toString() == "");
+    assert(sas.getCapacity() == 4);
+
+    // test push, top, toString, isFull
+    sas.push(10);
+    sas.push(20);
+    sas.push(30);
+    sas.push(40);
+    assert(sas.isFull() == true);
+    assert(sas.top() == 40);
+    assert(sas.toString() == "40\n30\n20\n10\n");
+
+    // test push on a full stack
+    bool thrown = false;
+    try {
+        sas.push(50);
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+    assert(sas.size() == 4);
+
+    // test pop, clear
+    assert(sas.pop() == 40);
+    assert(sas.toString() == "30\n20\n10\n");
+    sas.clear();
+    assert(sas.isEmpty() == true);
+
+    // test copy constructor, copy assignment operator
+    sas.push(1);
+    sas.push(2);
+    StaticArrayStack<int, 4> temp{sas};
+    assert(temp.toString() == "2\n1\n");
+    temp.pop();
+    sas = temp;
+    assert(sas.toString() == "1\n");
+
+    // test pushRange, popN
+    std::vector<int> values {2, 3, 4};
+    sas.pushRange(values.begin(), values.end());
+    std::vector<int> out(2);
+    sas.popN(2, out.begin());
+    assert((out == std::vector<int> {4, 3}));
+    assert(sas.toString() == "2\n1\n");
+}
+
+void testStringStack() {
+    // test non-trivial elements in inline storage
+    StaticArrayStack<std::string, 3> sas;
+    sas.push("a");
+    sas.emplace(2, 'b');
+    assert(sas.top() == "bb");
+
+    // test copy and move of inline elements
+    StaticArrayStack<std::string, 3> copied{sas};
+    StaticArrayStack<std::string, 3> moved{std::move(sas)};
+    assert(sas.isEmpty() == true);
+    assert(copied.pop() == "bb");
+    assert(moved.pop() == "bb");
+    assert(moved.pop() == "a");
+}
+
+void testSpill() {
+    // test spilling past N
+    StaticArrayStack<std::string, 2, true> sas;
+    sas.push("0");
+    sas.push("1");
+    assert(sas.isSpilled() == false);
+    sas.push("2");
+    assert(sas.isSpilled() == true);
+    assert(sas.getCapacity() == 4);
+    for (int i = 3; i < 20; ++i) {
+        sas.push(std::to_string(i));
+    }
+    assert(sas.size() == 20);
+    assert(sas.top() == "19");
+
+    // test copy of a spilled stack
+    StaticArrayStack<std::string, 2, true> copied{sas};
+    assert(copied.size() == 20);
+    for (int i = 19; i >= 0; --i) {
+        assert(copied.pop() == std::to_string(i));
+    }
+
+    // test move of a spilled stack steals the heap buffer
+    StaticArrayStack<std::string, 2, true> moved{std::move(sas)};
+    assert(moved.size() == 20);
+    assert(sas.isEmpty() == true);
+    assert(sas.isSpilled() == false);
+
+    // test trivial T with spilling
+    StaticArrayStack<int, 2, true> ints;
+    for (int i = 0; i < 10; ++i) {
+        ints.push(i);
+    }
+    assert(ints.toString() == "9\n8\n7\n6\n5\n4\n3\n2\n1\n0\n");
+
+    // test push(top()) when full: the argument lives in the storage the spill relocates
+    StaticArrayStack<std::string, 2, true> full;
+    full.push(std::string(40, 'a'));
+    full.push(std::string(40, 'b'));
+    full.push(full.top());
+    assert(full.isSpilled() == true);
+    full.push(full.top());
+    full.push(full.top());
+    assert(full.size() == 5);
+    assert(full.getCapacity() == 8);
+    for (int i = 0; i < 4; ++i) {
+        assert(full.pop() == std::string(40, 'b'));
+    }
+    assert(full.pop() == std::string(40, 'a'));
+}
+
+int main() {
+    testIntStack();
+    testStringStack();
+    testSpill();
+
+    return 0;
+}
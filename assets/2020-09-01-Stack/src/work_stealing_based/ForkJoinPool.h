@@ -0,0 +1,378 @@
+#ifndef FORK_JOIN_POOL_H
+#define FORK_JOIN_POOL_H
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <exception>
+#include <functional>
+#include "WorkStealingDeque.h"
+
+/**
+ * Minimal fork-join scheduler on WorkStealingDeque
+ *
+ * Every worker owns a deque: spawn() pushes onto the calling worker's deque,
+ * and a worker runs its own newest task first. A worker without work steals
+ * the oldest task of a random victim, which for recursive divide and conquer
+ * is the biggest piece left, so uneven trees still keep every worker busy.
+ *
+ * wait() does not block: the waiting worker keeps running and stealing tasks
+ * until its group is done. Tasks submitted from outside the pool go through a
+ * locked injection queue.
+ *
+ * A worker that finds nothing for IDLE_ROUNDS rounds parks on a condition
+ * variable, and spawn() wakes one parked worker per task, so an idle pool
+ * takes no CPU. Notifies are skipped when nobody is parked.
+ *
+ *     ForkJoinPool pool {4};
+ *     pool.run([&]() {
+ *         ForkJoinPool::TaskGroup group;
+ *         pool.spawn(group, [&]() { left(); });
+ *         right();
+ *         pool.wait(group);
+ *     });
+ */
+class ForkJoinPool {
+public:
+    // tasks that can be waited for together
+    class TaskGroup {
+    public:
+        TaskGroup() = default;
+
+        TaskGroup(const TaskGroup &) = delete;
+
+        TaskGroup& operator=(const TaskGroup &) = delete;
+
+    private:
+        friend class ForkJoinPool;
+
+        std::atomic<size_t> pending {0};
+
+        // the first exception thrown by a task of the group
+        std::exception_ptr error;
+
+        std::mutex errorLock;
+    };
+
+    // per worker counters, read them once the pool is idle
+    struct WorkerStats {
+        size_t executed;
+        size_t stolen;
+    };
+
+    // constructor, 0 workers means one per hardware thread
+    explicit ForkJoinPool(size_t workers = 0);
+
+    /////////////////////////  Big Five  /////////////////////////
+    // 1. destructor
+    virtual ~ForkJoinPool();
+
+    // 2. / 3. copy, 4. / 5. move: workers hold a pointer to the pool
+    ForkJoinPool(const ForkJoinPool &) = delete;
+
+    ForkJoinPool& operator=(const ForkJoinPool &) = delete;
+
+    ForkJoinPool(ForkJoinPool &&) = delete;
+
+    ForkJoinPool& operator=(ForkJoinPool &&) = delete;
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Principle Operations  ///////////////////
+    // run fn on the pool and wait for it, rethrows the first exception of fn or its tasks
+    void run(std::function<void()> fn);
+
+    // queue fn as part of group
+    void spawn(TaskGroup &group, std::function<void()> fn);
+
+    // run tasks until every task of group has finished, rethrows the first exception
+    void wait(TaskGroup &group);
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Auxiliary Operations  ///////////////////
+    size_t workerCount() const;
+
+    std::vector<WorkerStats> stats() const;
+
+    void resetStats();
+    //////////////////////////////////////////////////////////////
+
+private:
+    struct Task {
+        std::function<void()> fn;
+        TaskGroup *group;
+    };
+
+    struct alignas(64) Worker {
+        WorkStealingDeque<Task *> deque;
+        std::atomic<size_t> executed {0};
+        std::atomic<size_t> stolen {0};
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // tasks submitted by threads that are not workers
+    std::deque<Task *> injected;
+
+    std::mutex injectLock;
+
+    std::atomic<bool> stopping {false};
+
+    // failed task searches before a worker parks
+    static constexpr int IDLE_ROUNDS = 64;
+
+    // parked workers, announced before their last search so spawn() cannot miss them
+    std::atomic<size_t> sleepers {0};
+
+    // bumped under parkLock for every wake, a parked worker sleeps until it changes
+    std::atomic<uint64_t> signals {0};
+
+    std::mutex parkLock;
+
+    std::condition_variable wakeup;
+
+    ///////////////////  Auxiliary Functions  ////////////////////
+    // index of the calling worker of this pool, -1 for outside threads
+    long currentWorker() const;
+
+    void workerLoop(size_t id);
+
+    // sleep until a task may be there or the pool stops, the task found on the way if any
+    Task* park(long id, uint64_t &seed);
+
+    // wake one parked worker after a task was queued
+    void notifyTask();
+
+    // find a task for worker id (or an outside thread), nullptr if there is none
+    Task* findTask(long id, uint64_t &seed);
+
+    void execute(Task *task, long id);
+    //////////////////////////////////////////////////////////////
+
+    static thread_local const ForkJoinPool *currentPool;
+
+    static thread_local long currentId;
+};
+
+inline thread_local const ForkJoinPool *ForkJoinPool::currentPool = nullptr;
+
+inline thread_local long ForkJoinPool::currentId = -1;
+
+///////////////////  Function Implementation  ///////////////////
+// constructor
+inline ForkJoinPool::ForkJoinPool(size_t workers) {
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        this->workers.push_back(std::make_unique<Worker>());
+    }
+    // start the threads once every deque exists, they steal from each other
+    for (size_t i = 0; i < workers; ++i) {
+        this->workers[i]->thread = std::thread(&ForkJoinPool::workerLoop, this, i);
+    }
+}
+
+/////////////////////////  Big Five  /////////////////////////
+// 1. destructor
+inline ForkJoinPool::~ForkJoinPool() {
+    {
+        std::lock_guard<std::mutex> guard(parkLock);
+        stopping.store(true, std::memory_order_release);
+    }
+    wakeup.notify_all();
+    for (auto &w : workers) {
+        w->thread.join();
+    }
+    // tasks never waited for are dropped, their groups may be gone already
+    for (auto &w : workers) {
+        while (std::optional<Task *> task = w->deque.tryPop()) {
+            delete *task;
+        }
+    }
+    for (Task *task : injected) {
+        delete task;
+    }
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Principle Operations  ///////////////////
+inline void ForkJoinPool::run(std::function<void()> fn) {
+    TaskGroup group;
+    spawn(group, std::move(fn));
+    wait(group);
+}
+
+inline void ForkJoinPool::spawn(TaskGroup &group, std::function<void()> fn) {
+    Task *task = new Task {std::move(fn), &group};
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    long id = currentWorker();
+    if (id >= 0) {
+        workers[id]->deque.push(task);
+    } else {
+        std::lock_guard<std::mutex> lock(injectLock);
+        injected.push_back(task);
+    }
+    notifyTask();
+}
+
+inline void ForkJoinPool::wait(TaskGroup &group) {
+    long id = currentWorker();
+    uint64_t seed = reinterpret_cast<uintptr_t>(&group) | 1;
+    while (group.pending.load(std::memory_order_acquire) > 0) {
+        // help instead of blocking, outside threads only steal
+        Task *task = findTask(id, seed);
+        if (task != nullptr) {
+            execute(task, id);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    if (group.error) {
+        std::exception_ptr error = group.error;
+        group.error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Operations  ///////////////////
+inline size_t ForkJoinPool::workerCount() const {
+    return workers.size();
+}
+
+inline std::vector<ForkJoinPool::WorkerStats> ForkJoinPool::stats() const {
+    std::vector<WorkerStats> ret;
+    for (const auto &w : workers) {
+        ret.push_back({w->executed.load(std::memory_order_relaxed), w->stolen.load(std::memory_order_relaxed)});
+    }
+    return ret;
+}
+
+inline void ForkJoinPool::resetStats() {
+    for (auto &w : workers) {
+        w->executed.store(0, std::memory_order_relaxed);
+        w->stolen.store(0, std::memory_order_relaxed);
+    }
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Functions  ////////////////////
+inline long ForkJoinPool::currentWorker() const {
+    return currentPool == this ? currentId : -1;
+}
+
+inline void ForkJoinPool::workerLoop(size_t id) {
+    currentPool = this;
+    currentId = static_cast<long>(id);
+    uint64_t seed = id * 0x9E3779B97F4A7C15ULL + 1;
+    int idle = 0;
+    while (!stopping.load(std::memory_order_acquire)) {
+        Task *task = findTask(currentId, seed);
+        if (task == nullptr && ++idle >= IDLE_ROUNDS) {
+            task = park(currentId, seed);
+        }
+        if (task != nullptr) {
+            execute(task, currentId);
+            idle = 0;
+        } else if (idle < IDLE_ROUNDS) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+inline ForkJoinPool::Task* ForkJoinPool::park(long id, uint64_t &seed) {
+    std::unique_lock<std::mutex> lock(parkLock);
+    uint64_t seen = signals.load(std::memory_order_relaxed);
+    sleepers.fetch_add(1, std::memory_order_seq_cst);
+    // pairs with the fence in notifyTask: either this search sees the task or spawn() sees the sleeper
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    Task *task = findTask(id, seed);
+    if (task == nullptr) {
+        wakeup.wait(lock, [this, seen]() {
+            return stopping.load(std::memory_order_relaxed) || signals.load(std::memory_order_relaxed) != seen;
+        });
+    }
+    sleepers.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+}
+
+inline void ForkJoinPool::notifyTask() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    {
+        // under the lock, a worker between its last search and its wait cannot miss it
+        std::lock_guard<std::mutex> guard(parkLock);
+        signals.fetch_add(1, std::memory_order_relaxed);
+    }
+    wakeup.notify_one();
+}
+
+inline ForkJoinPool::Task* ForkJoinPool::findTask(long id, uint64_t &seed) {
+    // 1. own deque, newest first
+    if (id >= 0) {
+        if (std::optional<Task *> task = workers[id]->deque.tryPop()) {
+            return *task;
+        }
+    }
+
+    // 2. injection queue
+    {
+        std::unique_lock<std::mutex> lock(injectLock, std::try_to_lock);
+        if (lock.owns_lock() && !injected.empty()) {
+            Task *task = injected.front();
+            injected.pop_front();
+            return task;
+        }
+    }
+
+    // 3. one round over the other workers, starting at a random victim
+    size_t n = workers.size();
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    size_t start = static_cast<size_t>(seed % n);
+    for (size_t i = 0; i < n; ++i) {
+        size_t victim = (start + i) % n;
+        if (static_cast<long>(victim) == id) {
+            continue;
+        }
+        if (std::optional<Task *> task = workers[victim]->deque.steal()) {
+            if (id >= 0) {
+                workers[id]->stolen.fetch_add(1, std::memory_order_relaxed);
+            }
+            return *task;
+        }
+    }
+    return nullptr;
+}
+
+inline void ForkJoinPool::execute(Task *task, long id) {
+    std::unique_ptr<Task> owned {task};
+    try {
+        owned->fn();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(owned->group->errorLock);
+        if (!owned->group->error) {
+            owned->group->error = std::current_exception();
+        }
+    }
+    if (id >= 0) {
+        workers[id]->executed.fetch_add(1, std::memory_order_relaxed);
+    }
+    // last: the group may be destroyed as soon as pending reaches 0
+    owned->group->pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+//////////////////////////////////////////////////////////////
+
+#endif //FORK_JOIN_POOL_H
@@ -0,0 +1,244 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+using std::atomic;
+using std::vector;
+
+/**
+ * Chase-Lev work-stealing deque
+ *
+ * Array based like ArrayStack: the owner thread pushes and pops at the top
+ * (LIFO, so it keeps working on the hottest task), other threads steal from
+ * the bottom (FIFO, so they take the oldest and usually largest task).
+ *
+ * push is a plain store plus a release store of the top index. pop needs one
+ * sequentially consistent store (the only full barrier on the owner side),
+ * and a CAS only when owner and thieves race for the last element. Thieves
+ * always CAS the bottom index. No standalone fences are used, so the deque
+ * can be checked with ThreadSanitizer.
+ *
+ * The buffer is circular with a power of two capacity. When it is full, the
+ * owner copies the live range into a buffer of twice the size, like
+ * ArrayStack::grow(), and publishes it. A thief may still be reading the old
+ * buffer, so old buffers are only freed by the destructor.
+ *
+ * See: D. Chase and Y. Lev, "Dynamic Circular Work-Stealing Deque", SPAA 2005
+ *      N. M. Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models", PPoPP 2013
+ *
+ * @tparam T  generic type, expected to be trivially copyable (e.g. a task pointer)
+ */
+template<typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque needs a trivially copyable T.");
+
+public:
+    // constructor, size is rounded up to a power of two
+    explicit WorkStealingDeque(size_t size = 64);
+
+    /////////////////////////  Big Five  /////////////////////////
+    // 1. destructor
+    virtual ~WorkStealingDeque();
+
+    // 2. / 3. copy, 4. / 5. move: a shared deque is identified by its address
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+
+    WorkStealingDeque& operator=(const WorkStealingDeque &) = delete;
+
+    WorkStealingDeque(WorkStealingDeque &&) = delete;
+
+    WorkStealingDeque& operator=(WorkStealingDeque &&) = delete;
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Principle Operations  ///////////////////
+    // owner only
+    void push(T e);
+
+    // owner only
+    T pop();
+
+    // owner only, reports an empty deque with std::nullopt instead of throwing
+    std::optional<T> tryPop();
+
+    // any thread, std::nullopt if the deque is empty or another thread won the race
+    std::optional<T> steal();
+    //////////////////////////////////////////////////////////////
+
+    ///////////////////  Auxiliary Operations  ///////////////////
+    // the results below are snapshots, they may be stale once returned
+    bool isEmpty() const;
+
+    size_t size() const;
+
+    size_t getCapacity() const;
+    //////////////////////////////////////////////////////////////
+
+private:
+    struct Buffer {
+        int64_t capacity;
+        int64_t mask;
+        atomic<T> *slots;
+
+        explicit Buffer(int64_t capacity) : capacity {capacity}, mask {capacity - 1}, slots {new atomic<T>[capacity]} {
+        }
+
+        ~Buffer() {
+            delete[] slots;
+        }
+
+        T get(int64_t i) const {
+            return slots[i & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t i, T e) {
+            slots[i & mask].store(e, std::memory_order_relaxed);
+        }
+    };
+
+    // owner end, one past the newest element
+    alignas(64) atomic<int64_t> topIndex {0};
+
+    // thief end, the oldest element
+    alignas(64) atomic<int64_t> bottomIndex {0};
+
+    atomic<Buffer *> buffer;
+
+    // replaced buffers, a thief may still read them
+    vector<Buffer *> retired;
+
+    ///////////////////  Auxiliary Functions  ////////////////////
+    Buffer* grow(Buffer *old, int64_t bottom, int64_t top);
+    //////////////////////////////////////////////////////////////
+};
+
+///////////////////  Function Implementation  ///////////////////
+// constructor
+template<typename T>
+WorkStealingDeque<T>::WorkStealingDeque(size_t size) {
+    int64_t capacity = 1;
+    while (capacity < static_cast<int64_t>(size)) {
+        capacity *= 2;
+    }
+    buffer.store(new Buffer(capacity), std::memory_order_relaxed);
+}
+
+/////////////////////////  Big Five  /////////////////////////
+// 1. destructor
+template<typename T>
+WorkStealingDeque<T>::~WorkStealingDeque() {
+    delete buffer.load(std::memory_order_relaxed);
+    for (Buffer *b : retired) {
+        delete b;
+    }
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Principle Operations  ///////////////////
+template<typename T>
+void WorkStealingDeque<T>::push(T e) {
+    int64_t top = topIndex.load(std::memory_order_relaxed);
+    int64_t bottom = bottomIndex.load(std::memory_order_acquire);
+    Buffer *buf = buffer.load(std::memory_order_relaxed);
+    if (top - bottom > buf->capacity - 1) {
+        // full, double the capacity and copy
+        buf = grow(buf, bottom, top);
+    }
+    buf->put(top, e);
+    // the element must be visible before the new top
+    topIndex.store(top + 1, std::memory_order_release);
+}
+
+template<typename T>
+T WorkStealingDeque<T>::pop() {
+    std::optional<T> ret = tryPop();
+    if (!ret) {
+        throw std::runtime_error("Deque is empty.");
+    }
+    return *ret;
+}
+
+template<typename T>
+std::optional<T> WorkStealingDeque<T>::tryPop() {
+    int64_t top = topIndex.load(std::memory_order_relaxed) - 1;
+    Buffer *buf = buffer.load(std::memory_order_relaxed);
+    // reserve the element before looking at the thieves' index
+    topIndex.store(top, std::memory_order_seq_cst);
+    int64_t bottom = bottomIndex.load(std::memory_order_seq_cst);
+
+    if (bottom > top) {
+        // empty, undo the reservation
+        topIndex.store(top + 1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    T ret = buf->get(top);
+    if (bottom == top) {
+        // the last element, race the thieves for it
+        bool won = bottomIndex.compare_exchange_strong(bottom, bottom + 1,
+                                                       std::memory_order_seq_cst, std::memory_order_relaxed);
+        topIndex.store(top + 1, std::memory_order_relaxed);
+        if (!won) {
+            return std::nullopt;
+        }
+    }
+    return ret;
+}
+
+template<typename T>
+std::optional<T> WorkStealingDeque<T>::steal() {
+    int64_t bottom = bottomIndex.load(std::memory_order_seq_cst);
+    int64_t top = topIndex.load(std::memory_order_seq_cst);
+
+    if (bottom >= top) {
+        return std::nullopt;
+    }
+    Buffer *buf = buffer.load(std::memory_order_acquire);
+    T ret = buf->get(bottom);
+    if (!bottomIndex.compare_exchange_strong(bottom, bottom + 1,
+                                             std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        // lost against the owner or another thief
+        return std::nullopt;
+    }
+    return ret;
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Operations  ///////////////////
+template<typename T>
+bool WorkStealingDeque<T>::isEmpty() const {
+    return size() == 0;
+}
+
+template<typename T>
+size_t WorkStealingDeque<T>::size() const {
+    int64_t bottom = bottomIndex.load(std::memory_order_relaxed);
+    int64_t top = topIndex.load(std::memory_order_relaxed);
+    return top > bottom ? static_cast<size_t>(top - bottom) : 0;
+}
+
+template<typename T>
+size_t WorkStealingDeque<T>::getCapacity() const {
+    return static_cast<size_t>(buffer.load(std::memory_order_relaxed)->capacity);
+}
+//////////////////////////////////////////////////////////////
+
+///////////////////  Auxiliary Functions  ////////////////////
+template<typename T>
+typename WorkStealingDeque<T>::Buffer* WorkStealingDeque<T>::grow(Buffer *old, int64_t bottom, int64_t top) {
+    Buffer *temp = new Buffer(2 * old->capacity);
+    // element-wise copy of the live range, indices stay the same
+    for (int64_t i = bottom; i < top; ++i) {
+        temp->put(i, old->get(i));
+    }
+    retired.push_back(old);
+    buffer.store(temp, std::memory_order_release);
+    return temp;
+}
+//////////////////////////////////////////////////////////////
+
+#endif //WORK_STEALING_DEQUE_H
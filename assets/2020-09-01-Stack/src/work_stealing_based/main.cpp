@@ -0,0 +1,211 @@
+#include <iostream>
+#include <assert.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <stdexcept>
+#include <memory>
+#include "WorkStealingDeque.h"
+#include "ForkJoinPool.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::thread;
+
+void testDeque() {
+    // test constructor
+    WorkStealingDeque<int> wsd{2};
+    assert(wsd.isEmpty() == true);
+    assert(wsd.getCapacity() == 2);
+    assert(!wsd.tryPop());
+    assert(!wsd.steal());
+
+    // test push, growth: the owner end is LIFO
+    wsd.push(10);
+    wsd.push(20);
+    wsd.push(30);
+    assert(wsd.getCapacity() == 4);
+    assert(wsd.size() == 3);
+    assert(wsd.pop() == 30);
+
+    // test steal: the thief end is FIFO
+    assert(wsd.steal().value() == 10);
+    assert(wsd.tryPop().value() == 20);
+    assert(wsd.isEmpty() == true);
+
+    // test wrap around in the circular buffer
+    for (int round = 0; round < 10; ++round) {
+        wsd.push(round);
+        wsd.push(round + 100);
+        assert(wsd.steal().value() == round);
+        assert(wsd.pop() == round + 100);
+    }
+    assert(wsd.getCapacity() == 4);
+
+    // test pop on an empty deque
+    bool thrown = false;
+    try {
+        wsd.pop();
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+}
+
+void testStealStress() {
+    // the owner pushes (growing the buffer under the thieves) and pops,
+    // every value must be taken exactly once, by the owner or by a thief
+    const int thieves = 3;
+    const int total = 400000;
+
+    WorkStealingDeque<int> wsd{4};
+    vector<std::atomic<int>> seen(total);
+    std::atomic<int> taken {0};
+
+    vector<thread> threads;
+    for (int t = 0; t < thieves; ++t) {
+        threads.emplace_back([&]() {
+            while (taken.load() < total) {
+                std::optional<int> v = wsd.steal();
+                if (v) {
+                    seen[*v].fetch_add(1);
+                    taken.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (int i = 0; i < total; ++i) {
+        wsd.push(i);
+        // pop now and then, so that the owner races the thieves for the last element
+        if (i % 3 == 0) {
+            std::optional<int> v = wsd.tryPop();
+            if (v) {
+                seen[*v].fetch_add(1);
+                taken.fetch_add(1);
+            }
+        }
+    }
+    while (std::optional<int> v = wsd.tryPop()) {
+        seen[*v].fetch_add(1);
+        taken.fetch_add(1);
+    }
+    for (thread &t : threads) {
+        t.join();
+    }
+
+    assert(wsd.isEmpty() == true);
+    for (int i = 0; i < total; ++i) {
+        assert(seen[i].load() == 1);
+    }
+}
+
+long fib(ForkJoinPool &pool, int n) {
+    if (n < 2) {
+        return n;
+    }
+    if (n < 12) {
+        return fib(pool, n - 1) + fib(pool, n - 2);
+    }
+    long left = 0;
+    ForkJoinPool::TaskGroup group;
+    pool.spawn(group, [&]() { left = fib(pool, n - 1); });
+    long right = fib(pool, n - 2);
+    pool.wait(group);
+    return left + right;
+}
+
+// an uneven tree: the left child gets 90% of the range, the right one 10%
+long skewedSum(ForkJoinPool &pool, long lo, long hi) {
+    if (hi - lo < 2048) {
+        long sum = 0;
+        for (long i = lo; i < hi; ++i) {
+            sum += i;
+        }
+        return sum;
+    }
+    long mid = lo + (hi - lo) * 9 / 10;
+    long left = 0;
+    ForkJoinPool::TaskGroup group;
+    pool.spawn(group, [&]() { left = skewedSum(pool, lo, mid); });
+    long right = skewedSum(pool, mid, hi);
+    pool.wait(group);
+    return left + right;
+}
+
+void testForkJoin() {
+    ForkJoinPool pool{4};
+    assert(pool.workerCount() == 4);
+
+    // test run with a recursive workload
+    long ret = 0;
+    pool.run([&]() { ret = fib(pool, 25); });
+    assert(ret == 75025);
+
+    // test an uneven workload, and report how it was spread over the workers
+    pool.resetStats();
+    const long n = 4000000;
+    pool.run([&]() { ret = skewedSum(pool, 0, n); });
+    assert(ret == n * (n - 1) / 2);
+
+    size_t executed = 0;
+    vector<ForkJoinPool::WorkerStats> stats = pool.stats();
+    for (size_t i = 0; i < stats.size(); ++i) {
+        cout << "worker " << i << ": executed " << stats[i].executed << ", stolen " << stats[i].stolen << endl;
+        executed += stats[i].executed;
+    }
+    assert(executed > 0);
+
+    // test exception propagation
+    bool thrown = false;
+    try {
+        pool.run([&]() {
+            ForkJoinPool::TaskGroup group;
+            pool.spawn(group, []() { throw std::runtime_error("task failed"); });
+            pool.wait(group);
+        });
+    } catch (const std::runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+
+    // test an idle pool parks its workers: little CPU time while nothing is queued
+    std::clock_t before = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    double idleCpu = static_cast<double>(std::clock() - before) / CLOCKS_PER_SEC;
+    assert(idleCpu < 0.1);
+
+    // test parked workers wake up for new work, from outside and within the pool
+    for (int round = 0; round < 100; ++round) {
+        pool.run([&]() { ret = fib(pool, 10); });
+        assert(ret == 55);
+    }
+}
+
+void testDropUnwaitedTasks() {
+    // tasks still queued when the pool goes away are freed, not leaked: every task holds a token
+    // whose deleter counts, run or not, its closure is destroyed exactly once
+    ForkJoinPool::TaskGroup group;
+    std::atomic<int> ran {0};
+    std::atomic<int> destroyed {0};
+    {
+        ForkJoinPool pool{2};
+        for (int i = 0; i < 10000; ++i) {
+            std::shared_ptr<void> token {nullptr, [&destroyed](void *) { destroyed++; }};
+            pool.spawn(group, [&ran, token]() { ran++; });
+        }
+    }
+    assert(ran.load() <= 10000);
+    assert(destroyed.load() == 10000);
+}
+
+int main() {
+    testDeque();
+    testStealStress();
+    testForkJoin();
+    testDropUnwaitedTasks();
+
+    return 0;
+}
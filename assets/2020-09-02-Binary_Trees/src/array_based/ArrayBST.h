@@ -3,8 +3,17 @@
 
 #include <iostream>
 #include <algorithm>
+#include <iterator>
+#include <type_traits>
 #include <cmath>
 #include <set>
+#include <cstdint>
+#include <vector>
+#include <optional>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+#include "StaticKaryTree.h"
 
 using std::set;
 using std::cout;
@@ -15,10 +24,16 @@ using std::endl;
  * @tparam T          generic type, expected to overload operator=, operator<
  * @tparam SIZE
  * @tparam initValue
+ * @tparam BALANCED   scapegoat tree: an insert landing deeper than log_{1/alpha}(count) rebuilds the lowest
+ *                    ancestor whose heavier child holds more than alpha of its nodes around its median,
+ *                    a remove that leaves fewer than alpha of the peak count rebuilds the whole tree; both
+ *                    amortize to O(log count) per update, the capacity stays below 2 * peak^(1 / log2(1 / alpha))
  */
-template<typename T, T initValue, size_t SIZE = 1> // index 0 is not used
+template<typename T, T initValue, size_t SIZE = 1, bool BALANCED = false> // index 0 is not used
 class ArrayBST {
 public:
+    class Iterator;
+
     // default constructor
     ArrayBST();
 
@@ -51,8 +66,50 @@ public:
 
     T remove(size_t index, T value);
 
+    // remove that reports an empty tree or a missing value with std::nullopt instead of throwing
+    std::optional<T> tryRemove(T value) noexcept;
+
+    // remove in O(depth) by turning the node into a tombstone: the slot keeps its value to route
+    // searches and is skipped by every query; the highest subtree on the path whose tombstones
+    // outnumber its live nodes is rebuilt without them, so the cost of a rebuild is spread over
+    // the removes that caused it and never spans more of the tree than they do
+    std::optional<T> lazyRemove(T value) noexcept;
+
+    // rebuild the live nodes into a complete tree, dropping every tombstone
+    void compact();
+
+    // replace the tree by the n sorted keys laid out in Eytzinger order: a perfectly
+    // balanced tree filling indices 1..n without gaps, built in O(n)
+    void buildFromSorted(const T *keys, size_t n);
+
+    // replace the tree by the distinct values among n keys in any order, laid out as in
+    // buildFromSorted; sorting and layout run on threads threads, 0 for one per core
+    void bulkLoad(const T *keys, size_t n, size_t threads = 0);
+
     T searchByValue(T value);
 
+    // smallest value >= value, std::nullopt if there is none
+    std::optional<T> lowerBound(T value) const noexcept;
+
+    bool contains(T value) const noexcept;
+
+    // order statistics over the live values, O(depth) each through the subtree sizes
+    // number of values < value
+    size_t rank(T value) const noexcept;
+
+    // number of values in [lo, hi]
+    size_t countInRange(T lo, T hi) const noexcept;
+
+    // the k-th smallest value, k counted from 0
+    T select(size_t k) const;
+
+    // write the values in [lo, hi] to out in order, O(depth + reported)
+    template<typename OutputIt>
+    OutputIt collectRange(T lo, T hi, OutputIt out) const;
+
+    // an immutable copy of the live values in a cache line wide k-ary layout, for read-only lookups
+    StaticKaryTree<T> freeze() const;
+
     void preOrder(size_t index);
 
     void inOrder(size_t index);
@@ -61,6 +118,31 @@ public:
 
     void levelOrder(size_t index);
 
+    // the four traversals of the subtree at index without recursion, printing or extra memory: every
+    // live node is handed to visitor(const T &); a visitor returning bool stops the walk with false,
+    // forEach* then returns false as well
+    template<typename Visitor>
+    bool forEachPreOrder(Visitor visitor, size_t index = 1) const;
+
+    template<typename Visitor>
+    bool forEachInOrder(Visitor visitor, size_t index = 1) const;
+
+    template<typename Visitor>
+    bool forEachPostOrder(Visitor visitor, size_t index = 1) const;
+
+    // level order is ascending index order, a scan of the occupancy bitmap
+    template<typename Visitor>
+    bool forEachLevelOrder(Visitor visitor, size_t index = 1) const;
+
+    // bidirectional in-order iteration over the live nodes, invalidated by any modification
+    Iterator begin() const;
+
+    Iterator end() const;
+
+    std::reverse_iterator<Iterator> rbegin() const;
+
+    std::reverse_iterator<Iterator> rend() const;
+
     int getHeight();
 
     T getRootValue();
@@ -72,12 +154,21 @@ public:
 
     size_t countNodes() const;
 
+    size_t getCapacity() const;
+
+    size_t countTombstones() const;
+
     void visualizeBST();
 
     T minValue();
 
     T maxValue();
 
+    // std::nullopt for an empty tree
+    std::optional<T> tryMinValue() const noexcept;
+
+    std::optional<T> tryMaxValue() const noexcept;
+
     //////////////////////////////////////////////////////////////////
 
 private:
@@ -89,60 +180,294 @@ private:
 
     T initVal;
 
+    // largest count since the last full rebuild, BALANCED only
+    size_t maxCount;
+
+    // bit i is set iff slot i holds a node, kept in step with the initValue sentinels
+    // so whole-tree operations can skip 64 empty slots at a time
+    std::vector<uint64_t> occupancy;
+
+    // bit i is set iff slot i holds a node removed by lazyRemove, such a slot is occupied but not counted
+    std::vector<uint64_t> tombstones;
+
+    size_t tombstoneCount;
+
+    // sizes[i] is the number of live nodes in the subtree at slot i, capacity + 1 entries
+    std::vector<size_t> sizes;
+
+    // tombstoneSizes[i] is the number of tombstones in the subtree at slot i, capacity + 1 entries
+    std::vector<size_t> tombstoneSizes;
+
     const size_t rootId = 1;
 
+    // weight balance of a BALANCED tree: a child may hold at most this share of its parent's subtree;
+    // closer to 1/2 keeps the array smaller, closer to 1 rebuilds less often
+    static constexpr double BALANCE_ALPHA = 0.52;
+
+    // lookups prefetch the descendants this many levels below the current node
+    static constexpr size_t PREFETCH_LEVELS = 4;
+
+    static constexpr size_t WORD_BITS = 64;
+
     /////////////////////// Auxiliary Function ///////////////////////
     void destroyTree();
 
+    static void prefetch(const T *address);
+
+    // every slot write goes through here to keep occupancy in step, the slot is live afterwards;
+    // emptying a slot zeroes its size, the sizes of a filled slot are up to the caller
+    void setSlot(size_t index, const T &value);
+
+    // one live node more or less in the subtree at index, so in index and all its ancestors
+    void incrementSizes(size_t index);
+
+    void decrementSizes(size_t index);
+
+    // delta tombstones more in index and all its ancestors, fewer for a negative delta
+    void shiftTombstoneSizes(size_t index, std::ptrdiff_t delta);
+
+    // turn the live node at index into a tombstone, the sizes are up to the caller
+    void setTombstone(size_t index);
+
+    // a live slot holding value, 0 if there is none
+    size_t findLiveIndex(T value) const noexcept;
+
+    // live values < value, or <= value with inclusive
+    size_t countBelow(T value, bool inclusive) const noexcept;
+
+    bool isTombstone(size_t index) const;
+
+    // call visit(index) for every occupied index in [begin, end), ascending; a visit returning
+    // false stops the scan, forEachOccupied then returns false
+    template<typename Visitor>
+    bool forEachOccupied(size_t begin, size_t end, Visitor visit) const;
+
+    bool hasNode(size_t index) const;
+
+    // neighbours within the subtree at root by index arithmetic, 0 if there is none; tombstones included
+    size_t successorIndex(size_t index, size_t root) const;
+
+    size_t predecessorIndex(size_t index, size_t root) const;
+
+    size_t preOrderNext(size_t index, size_t root) const;
+
+    // the deepest node reached by going left whenever possible
+    size_t postOrderFirst(size_t root) const;
+
+    size_t postOrderNext(size_t index, size_t root) const;
+
+    // call visitor(value), false if it asks to stop
+    template<typename Visitor>
+    static bool proceed(Visitor &visitor, const T &value);
+
+    // first slot holding a value >= value, tombstones included, 0 if there is none
+    size_t lowerBoundIndex(T value) const noexcept;
+
+    // occupancy words covering slots 0..capacity
+    static size_t wordsFor(size_t capacity);
+
+    static size_t highestBit(uint64_t word);
+
+    static size_t lowestBit(uint64_t word);
+
+    // copy the slots of the non-empty occupancy words, to is already filled with initValue
+    static void copyOccupied(const T *from, const std::vector<uint64_t> &occupied, size_t capacity, T *to);
+
+    // lay out n sorted keys with the checks done: the top levels here, the subtrees below them
+    // on threads threads, each filling whole subtrees
+    void layOutSorted(const T *keys, size_t n, size_t threads);
+
+    // call work(i) for i in [0, tasks) on threads threads, the calling one included
+    template<typename Work>
+    static void parallelFor(size_t tasks, size_t threads, Work work);
+
+    // sort chunks on threads threads, then merge neighbouring runs pairwise in rounds
+    static void parallelSort(std::vector<T> &keys, size_t threads);
+
+    // write n sorted keys in order into the complete tree shape of n nodes hanging at root
+    static void fillInOrder(T *tree, size_t root, const T *keys, size_t n);
+
+    // set the occupancy bits of the complete tree shape of n nodes hanging at root
+    static void markComplete(std::vector<uint64_t> &occupied, size_t root, size_t n);
+
+    // in the complete tree shape of n nodes at the root: the nodes in the subtree at index,
+    // and the nodes before that subtree in order
+    static size_t completeSubtreeSize(size_t index, size_t n);
+
+    static size_t completeKeysBefore(size_t index, size_t n);
+
+    // set the sizes of the complete tree shape of n nodes hanging at root
+    static void fillSizes(std::vector<size_t> &sizes, size_t root, size_t n);
+
+    // level of an index, the root is on level 1; equally the height of a complete tree of n nodes
+    static size_t levelOf(size_t index);
+
+    // the three below skip tombstones: only live nodes are counted and collected
+    // 0 beyond capacity
+    size_t subtreeSize(size_t index) const;
+
+    void collectInOrder(size_t index, std::vector<T> &out) const;
+
+    void clearSubtree(size_t index);
+
+    // hang the n sorted keys at index with the median on top, so no child holds more than half
+    // of a subtree; a complete shape would leave left children with up to two thirds
+    void fillBalanced(size_t index, const T *keys, size_t n);
+
+    // deepest level an insert may reach in a BALANCED tree of n nodes, 1 + log_{1/alpha}(n)
+    static size_t balancedLevels(size_t n);
+
+    // place value by rebuilding the scapegoat, the lowest ancestor of slot out of weight balance
+    void rebuildForInsert(size_t slot, T value);
+
+    // replace the subtree at node by the sorted keys hung around their median, dropping its tombstones;
+    // the ancestors lose the dropped tombstones, their live sizes are up to the caller
+    void rebuildSubtree(size_t node, const std::vector<T> &keys);
+
+    // rebuild the whole tree as a complete tree in a right-sized array
+    void rebuildAll();
+
     void doublesize();
 
-    void reorganizeSubtree(size_t subtreeRootIndex, size_t subtreeRootIndexMoveTo = -1);
+    // move the subtree at subtreeRootIndex up to its parent subtreeRootIndexMoveTo, whose other child
+    // must be empty; the nodes move level by level so a node never lands on one not yet moved
+    void reorganizeSubtree(size_t subtreeRootIndex, size_t subtreeRootIndexMoveTo);
 
     size_t findMinimumIndex(size_t currentIndex);
 
 };
 
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+class ArrayBST<T, initValue, SIZE, BALANCED>::Iterator {
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    Iterator() = default;
+
+    reference operator*() const {
+        return tree->bst[index];
+    }
+
+    pointer operator->() const {
+        return tree->bst + index;
+    }
+
+    Iterator& operator++() {
+        do {
+            index = tree->successorIndex(index, tree->rootId);
+        } while (index != 0 && tree->isTombstone(index));
+        return *this;
+    }
+
+    Iterator operator++(int) {
+        Iterator ret = *this;
+        ++*this;
+        return ret;
+    }
+
+    // end() steps back to the maximum
+    Iterator& operator--() {
+        if (index == 0) {
+            index = tree->rootId;
+            while (tree->hasNode(index * 2 + 1)) {
+                index = index * 2 + 1;
+            }
+        } else {
+            index = tree->predecessorIndex(index, tree->rootId);
+        }
+        while (index != 0 && tree->isTombstone(index)) {
+            index = tree->predecessorIndex(index, tree->rootId);
+        }
+        return *this;
+    }
+
+    Iterator operator--(int) {
+        Iterator ret = *this;
+        --*this;
+        return ret;
+    }
+
+    bool operator==(const Iterator &other) const {
+        return index == other.index;
+    }
+
+    bool operator!=(const Iterator &other) const {
+        return index != other.index;
+    }
+
+private:
+    friend class ArrayBST;
+
+    Iterator(const ArrayBST *tree, size_t index) : tree {tree}, index {index} {
+    }
+
+    const ArrayBST *tree = nullptr;
+
+    // 0 is end()
+    size_t index = 0;
+};
+
 /////////////////////// Function Implementation ///////////////////////
 // default constructor
-template<typename T, T initValue, size_t SIZE>
-ArrayBST<T, initValue, SIZE>::ArrayBST() : bst {new T[SIZE]}, count{0}, capacity {SIZE}, initVal {initValue} {
-    std::fill_n(bst, capacity, initValue);
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+ArrayBST<T, initValue, SIZE, BALANCED>::ArrayBST() : bst {new T[SIZE + 1]}, count{0}, capacity {SIZE}, initVal {initValue}, maxCount {0},
+                                                     occupancy(wordsFor(SIZE)), tombstones(wordsFor(SIZE)), tombstoneCount {0},
+                                                     sizes(SIZE + 1), tombstoneSizes(SIZE + 1) {
+    std::fill_n(bst, capacity + 1, initValue);
 }
 
 // constructor
-template<typename T, T initValue, size_t SIZE>
-ArrayBST<T, initValue, SIZE>::ArrayBST(T rootValue) {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+ArrayBST<T, initValue, SIZE, BALANCED>::ArrayBST(T rootValue) {
     // keep references
     count = 1;
     capacity = SIZE;
     initVal = initValue;
+    maxCount = 1;
+    occupancy.assign(wordsFor(SIZE), 0);
+    tombstones.assign(wordsFor(SIZE), 0);
+    tombstoneCount = 0;
+    sizes.assign(SIZE + 1, 0);
+    tombstoneSizes.assign(SIZE + 1, 0);
     // fill bst with initVal values
     bst = new T[SIZE + 1];
     std::fill_n(bst, capacity + 1, initValue);
     // set root value
-    bst[rootId] = rootValue;
+    setSlot(rootId, rootValue);
+    sizes[rootId] = 1;
 }
 
 // compare two BSTs
-template<typename T, T initValue, size_t SIZE>
-bool ArrayBST<T, initValue, SIZE>::operator==(const ArrayBST &abst) {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+bool ArrayBST<T, initValue, SIZE, BALANCED>::operator==(const ArrayBST &abst) {
     if (count != abst.count) {
         return false;
     }
-    for (int i = 1; i <= std::min(capacity, abst.capacity); ++i) {
-        if (bst[i] != initVal && abst.bst[i] != abst.initVal && bst[i] != abst.bst[i]) {
+    // same shape means same occupancy and tombstones, whatever the capacities
+    // the slots of a word holding nodes are compared as one block, the empty ones
+    // hold initValue on both sides
+    size_t lastIndex = std::min(capacity, abst.capacity);
+    for (size_t w = 0; w < std::max(occupancy.size(), abst.occupancy.size()); ++w) {
+        uint64_t mine = w < occupancy.size() ? occupancy[w] : 0;
+        uint64_t theirs = w < abst.occupancy.size() ? abst.occupancy[w] : 0;
+        if (mine != theirs) {
             return false;
         }
-    }
-    // check if one of the trees has more un-null nodes
-    // if all actual nodes have the same data, then consider two BSTs are same
-    // although one may has bigger capacity
-    for (int i = std::min(capacity, abst.capacity) + 1; i <= std::max(capacity, abst.capacity); ++i) {
-        if (i <= capacity && bst[i] != initVal) {
+        uint64_t myTombstones = w < tombstones.size() ? tombstones[w] : 0;
+        uint64_t theirTombstones = w < abst.tombstones.size() ? abst.tombstones[w] : 0;
+        if (myTombstones != theirTombstones) {
             return false;
         }
-        if (i <= abst.capacity && abst.bst[i] != abst.initVal) {
-            return false;
+        if (mine != 0) {
+            size_t begin = w * WORD_BITS;
+            size_t end = std::min(begin + WORD_BITS, lastIndex + 1);
+            if (!std::equal(bst + begin, bst + end, abst.bst + begin)) {
+                return false;
+            }
         }
     }
     return true;
@@ -150,107 +475,132 @@ bool ArrayBST<T, initValue, SIZE>::operator==(const ArrayBST &abst) {
 
 //////////////////////////// Big Five  /////////////////////////////
 // 1. destructor
-template<typename T, T initValue, size_t SIZE>
-ArrayBST<T, initValue, SIZE>::~ArrayBST() {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+ArrayBST<T, initValue, SIZE, BALANCED>::~ArrayBST() {
     destroyTree();
 }
 
 // 2. copy constructor
-template<typename T, T initValue, size_t SIZE>
-ArrayBST<T, initValue, SIZE>::ArrayBST(const ArrayBST &abst) {
-    if (!isEmpty()) {
-        // destroy the current BST
-        destroyTree();
-    }
-    // allocation
-    bst = new T[abst.capacity + 1];
-    // copy element-wisely
-    for (int i = 0; i <= abst.capacity; ++i) {
-        // shallow copy or deep copy depends on the implementation of operator= overload in T
-        bst[i] = abst[i];
-    }
-    count = abst.count;
-    capacity = abst.capacity;
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+ArrayBST<T, initValue, SIZE, BALANCED>::ArrayBST(const ArrayBST &abst) : bst {new T[abst.capacity + 1]}, count {abst.count},
+                                                                         capacity {abst.capacity}, initVal {abst.initVal},
+                                                                         maxCount {abst.maxCount}, occupancy {abst.occupancy},
+                                                                         tombstones {abst.tombstones},
+                                                                         tombstoneCount {abst.tombstoneCount},
+                                                                         sizes {abst.sizes},
+                                                                         tombstoneSizes {abst.tombstoneSizes} {
+    std::fill_n(bst, capacity + 1, initValue);
+    // copy element-wisely, skipping the empty words
+    // shallow copy or deep copy depends on the implementation of operator= overload in T
+    copyOccupied(abst.bst, abst.occupancy, capacity, bst);
 }
 
 // 3. copy assignment operator=
-template<typename T, T initValue, size_t SIZE>
-ArrayBST<T, initValue, SIZE>& ArrayBST<T, initValue, SIZE>::operator=(const ArrayBST &abst) {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+ArrayBST<T, initValue, SIZE, BALANCED>& ArrayBST<T, initValue, SIZE, BALANCED>::operator=(const ArrayBST &abst) {
     // check self-assignment
     if (this == &abst) {
         return *this;
     }
-    if (!isEmpty()) {
-        // destroy the current BST
-        destroyTree();
-    }
-    // allocation
-    bst = new T[abst.capacity + 1];
-    // copy element-wisely
-    for (int i = 0; i <= abst.capacity; ++i) {
-        // shallow copy or deep copy depends on the implementation of operator= overload in T
-        bst[i] = abst[i];
-    }
+    // allocation, the current BST survives a failure
+    std::vector<uint64_t> tempOccupancy {abst.occupancy};
+    std::vector<uint64_t> tempTombstones {abst.tombstones};
+    std::vector<size_t> tempSizes {abst.sizes};
+    std::vector<size_t> tempTombstoneSizes {abst.tombstoneSizes};
+    T *temp = new T[abst.capacity + 1];
+    std::fill_n(temp, abst.capacity + 1, initValue);
+    // copy element-wisely, skipping the empty words
+    copyOccupied(abst.bst, abst.occupancy, abst.capacity, temp);
+
+    // destroy the current BST
+    destroyTree();
+    bst = temp;
     count = abst.count;
     capacity = abst.capacity;
+    maxCount = abst.maxCount;
+    occupancy = std::move(tempOccupancy);
+    tombstones = std::move(tempTombstones);
+    tombstoneCount = abst.tombstoneCount;
+    sizes = std::move(tempSizes);
+    tombstoneSizes = std::move(tempTombstoneSizes);
 
     return *this;
 }
 
 // 4. move constructor
-template<typename T, T initValue, size_t SIZE>
-ArrayBST<T, initValue, SIZE>::ArrayBST(ArrayBST &&abst) noexcept {
-    if (abst.isEmpty()) {
-        return;
-    }
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+ArrayBST<T, initValue, SIZE, BALANCED>::ArrayBST(ArrayBST &&abst) noexcept : bst {abst.bst}, count {abst.count},
+                                                                             capacity {abst.capacity}, initVal {abst.initVal},
+                                                                             maxCount {abst.maxCount},
+                                                                             occupancy {std::move(abst.occupancy)},
+                                                                             tombstones {std::move(abst.tombstones)},
+                                                                             tombstoneCount {abst.tombstoneCount},
+                                                                             sizes {std::move(abst.sizes)},
+                                                                             tombstoneSizes {std::move(abst.tombstoneSizes)} {
     // steal everything from abst to initialzie *this
-    // for simplicity, just make bst pointer point to abst.bst and redirect abst.bst to nullptr
-    bst = abst.bst;
-    count = abst.count;
-    capacity = abst.capacity;
-
     // reset abst to stable states
     abst.bst = nullptr;
     abst.count = 0;
     abst.capacity = 0;
+    abst.maxCount = 0;
+    abst.occupancy.clear();
+    abst.tombstones.clear();
+    abst.tombstoneCount = 0;
+    abst.sizes.clear();
+    abst.tombstoneSizes.clear();
 }
 
 // 5. move assignment operator=
-template<typename T, T initValue, size_t SIZE>
-ArrayBST<T, initValue, SIZE>& ArrayBST<T, initValue, SIZE>::operator=(ArrayBST &&abst) noexcept {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+ArrayBST<T, initValue, SIZE, BALANCED>& ArrayBST<T, initValue, SIZE, BALANCED>::operator=(ArrayBST &&abst) noexcept {
     // check self-assignment
     if (this == &abst) {
         return *this;
     }
-    if (!isEmpty()) {
-        // destroy the current BST
-        destroyTree();
-    }
+    // destroy the current BST
+    destroyTree();
     // steal everything from abst to initialzie *this
     // for simplicity, just make bst pointer point to abst.bst and redirect abst.bst to nullptr
     bst = abst.bst;
     count = abst.count;
     capacity = abst.capacity;
+    maxCount = abst.maxCount;
+    occupancy = std::move(abst.occupancy);
+    tombstones = std::move(abst.tombstones);
+    tombstoneCount = abst.tombstoneCount;
+    sizes = std::move(abst.sizes);
+    tombstoneSizes = std::move(abst.tombstoneSizes);
 
     // reset abst to stable states
     abst.bst = nullptr;
     abst.count = 0;
     abst.capacity = 0;
+    abst.maxCount = 0;
+    abst.occupancy.clear();
+    abst.tombstones.clear();
+    abst.tombstoneCount = 0;
+    abst.sizes.clear();
+    abst.tombstoneSizes.clear();
 
     return *this;
 }
 
 
 /////////////////////// Principle Operations ///////////////////////
-template<typename T, T initValue, size_t SIZE>
-void ArrayBST<T, initValue, SIZE>::insert(T value) {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::insert(T value) {
     size_t currId = rootId;
-    if (bst[currId] == initValue) {
-        // current BST is empty
-        bst[currId] = value;
-    }
-
-    while (bst[currId] != initValue) {
+    while (currId <= capacity && bst[currId] != initValue) {
+        if (tombstoneCount > 0 && bst[currId] == value && isTombstone(currId)) {
+            // a removed node with the same value is already in place, bring it back
+            setSlot(currId, value);
+            incrementSizes(currId);
+            shiftTombstoneSizes(currId, -1);
+            tombstoneCount--;
+            count++;
+            maxCount = std::max(maxCount, count);
+            return;
+        }
         if (value < bst[currId]) {
             // value should be inserted in the left subtree
             currId = currId * 2;
@@ -258,26 +608,50 @@ void ArrayBST<T, initValue, SIZE>::insert(T value) {
             // value should be inserted in the right subtree
             currId = currId * 2 + 1;
         }
-        if (currId > capacity) {
-            // double the capacity
-            doublesize();
-        }
     }
     // so far, we have found the correct index to insert
 
+    if constexpr (BALANCED) {
+        if (levelOf(currId) > balancedLevels(count + 1)) {
+            // too deep, restructure instead of growing
+            rebuildForInsert(currId, value);
+            count++;
+            maxCount = std::max(maxCount, count);
+            return;
+        }
+    }
+    while (currId > capacity) {
+        // double the capacity
+        doublesize();
+    }
+
     // assign the value
-    bst[currId] = value;
+    setSlot(currId, value);
+    incrementSizes(currId);
     count++;
+    maxCount = std::max(maxCount, count);
 }
 
-template<typename T, T initValue, size_t SIZE>
-T ArrayBST<T, initValue, SIZE>::remove(size_t index, T value) {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+T ArrayBST<T, initValue, SIZE, BALANCED>::remove(size_t index, T value) {
     if (isEmpty()) {
         throw std::runtime_error("BST is empty, invalid remove.");
     }
-    // search for the node with value in the BST
-    size_t curr = rootId;
-    while (curr <= capacity && bst[curr] != value && bst[curr] != initValue) {
+    std::optional<T> ret = tryRemove(value);
+    if (!ret) {
+        throw std::runtime_error("value is not found in BST.");
+    }
+    return *ret;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+std::optional<T> ArrayBST<T, initValue, SIZE, BALANCED>::tryRemove(T value) noexcept {
+    if (isEmpty()) {
+        return std::nullopt;
+    }
+    // search for the node with value in the BST, a removed node may shadow a live one with the same value
+    size_t curr = tombstoneCount > 0 ? findLiveIndex(value) : rootId;
+    while (curr != 0 && curr <= capacity && bst[curr] != value && bst[curr] != initValue) {
         if (value < bst[curr]) {
             // search in the left subtree
             curr = 2 * curr;
@@ -286,71 +660,193 @@ T ArrayBST<T, initValue, SIZE>::remove(size_t index, T value) {
             curr = 2 * curr + 1;
         }
     }
-    // so far, we should either find the appropriate index or bst[curr] = initValue or curr > capacity
+    // so far, we should either find the appropriate index or bst[curr] = initValue or curr > capacity or 0
 
-    if (curr > capacity || bst[curr] == initValue) {
+    if (curr == 0 || curr > capacity || bst[curr] == initValue) {
         // if node with the value is not found
-        throw std::runtime_error("value is not found in BST.");
+        return std::nullopt;
+    }
+    T ret = bst[curr];
+    size_t leftChildIdx = curr * 2;
+    size_t rightChildIdx = curr * 2 + 1;
+    bool hasLeftChild = leftChildIdx <= capacity && bst[leftChildIdx] != initValue;
+    bool hasRightChild = rightChildIdx <= capacity && bst[rightChildIdx] != initValue;
+    if (!hasLeftChild && !hasRightChild) {
+        // scenario 1: leaf node, the node has no children
+        setSlot(curr, initValue);  // reset current to initial value
+        decrementSizes(curr / 2);
+    } else if (hasLeftChild && !hasRightChild) {
+        // scenario 2.1: partial internal node with a left child
+        // the left subtree moves up one level, its root replacing the current node
+        reorganizeSubtree(leftChildIdx, curr);
+        decrementSizes(curr / 2);
+    } else if (!hasLeftChild && hasRightChild) {
+        // scenario 2.2: partial internal node with a right child
+        // the right subtree moves up one level, its root replacing the current node
+        reorganizeSubtree(rightChildIdx, curr);
+        decrementSizes(curr / 2);
     } else {
-        T ret = -1;
-        size_t leftChildIdx = curr * 2;
-        size_t rightChildIdx = curr * 2 + 1;
-        if (leftChildIdx < capacity && rightChildIdx < capacity) {
-            if (bst[leftChildIdx] == initValue && bst[rightChildIdx] == initValue) {
-                // scenario 1: leaf node, the node has no children
-                ret = bst[curr];
-                bst[curr] = initValue;  // reset current to initial value
-                count--;
-            } else if (bst[leftChildIdx] != initValue && bst[rightChildIdx] == initValue) {
-                // scenario 2.1: partial internal node with a left child
-                // replace current value with the value of left child
-                ret = bst[curr];
-                bst[curr] = bst[leftChildIdx];
-                // update left subtree recursively
-                reorganizeSubtree(leftChildIdx, curr);
-                count--;
-            } else if (bst[leftChildIdx] == initValue && bst[rightChildIdx] != initValue) {
-                // scenario 2.2: partial internal node with a right child
-                // replace current value with the value of right child
-                ret = bst[curr];
-                bst[curr] = bst[rightChildIdx];
-                // update right subtree recursively
-                reorganizeSubtree(rightChildIdx, curr);
-                count--;
-            } else if (bst[leftChildIdx] != initValue && bst[rightChildIdx] != initValue) {
-                // scenario 3: complete internal node with two children
-                // step 1: find the index of minimum node in the right subtree
-                size_t minimumNodeIndex = findMinimumIndex(rightChildIdx);
-                // step 2: replace the value of current node with the minimum value
-                ret = bst[curr];
-                bst[curr] = bst[minimumNodeIndex];
-                // step 3: remove the minimum node
-                // because minimumNode should be the leftmost node in the right subtree
-                // it shouldn't have a left child, so only reorganizing its right subtree is necessary
-                // if the right subtree exists
-                bst[minimumNodeIndex] = initValue;
-                if (2 * minimumNodeIndex + 1 <= capacity && bst[2 * minimumNodeIndex + 1] != initValue) {
-                    // move right value to the minimumIndex which is moved to root
-                    bst[minimumNodeIndex] = bst[2 * minimumNodeIndex + 1];
-                    // set right value to initVal
-                    bst[2 * minimumNodeIndex + 1] = initVal;
-                    // reorganize the right subtree
-                    reorganizeSubtree(2 * minimumNodeIndex + 1, minimumNodeIndex);
-                }
-                count--;
+        // scenario 3: complete internal node with two children
+        // step 1: find the index of minimum node in the right subtree
+        size_t minimumNodeIndex = findMinimumIndex(rightChildIdx);
+        // step 2: replace the value of current node with the minimum value, a tombstone stays one
+        bool minimumRemoved = isTombstone(minimumNodeIndex);
+        setSlot(curr, bst[minimumNodeIndex]);
+        if (minimumRemoved) {
+            setTombstone(curr);
+        }
+        // step 3: remove the minimum node
+        // because minimumNode should be the leftmost node in the right subtree
+        // it shouldn't have a left child, so only its right subtree has to move up, if it exists
+        size_t minimumRightIndex = 2 * minimumNodeIndex + 1;
+        if (minimumRightIndex <= capacity && bst[minimumRightIndex] != initValue) {
+            reorganizeSubtree(minimumRightIndex, minimumNodeIndex);
+        } else {
+            setSlot(minimumNodeIndex, initValue);
+        }
+        // the subtree now at minimumNodeIndex moved as a whole, its sizes came along
+        if (minimumRemoved) {
+            // the tombstone left the nodes below curr, the removed value left curr and above
+            for (size_t index = minimumNodeIndex / 2; index != curr; index /= 2) {
+                tombstoneSizes[index]--;
             }
+            decrementSizes(curr);
         } else {
-            // scenario 1: leaf node, the node has no children
-            ret = bst[curr];
-            bst[curr] = initValue;
-            count--;
+            decrementSizes(minimumNodeIndex / 2);
         }
-        return ret;
     }
+    count--;
+    if constexpr (BALANCED) {
+        if (count < BALANCE_ALPHA * maxCount) {
+            try {
+                rebuildAll();
+            } catch (...) {
+                // out of memory: keep the larger array, the next remove retries
+            }
+        }
+    }
+    return ret;
 }
 
-template<typename T, T initValue, size_t SIZE>
-T ArrayBST<T, initValue, SIZE>::searchByValue(T value) {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+std::optional<T> ArrayBST<T, initValue, SIZE, BALANCED>::lazyRemove(T value) noexcept {
+    size_t curr = findLiveIndex(value);
+    if (curr == 0) {
+        return std::nullopt;
+    }
+
+    setTombstone(curr);
+    decrementSizes(curr);
+    shiftTombstoneSizes(curr, 1);
+    tombstoneCount++;
+    count--;
+
+    // the highest subtree on the path that holds more tombstones than live nodes
+    size_t dominated = 0;
+    for (size_t index = curr; index != 0; index /= 2) {
+        dominated = tombstoneSizes[index] > sizes[index] ? index : dominated;
+    }
+    try {
+        if (dominated == rootId) {
+            compact();
+        } else if (dominated != 0) {
+            std::vector<T> keys;
+            keys.reserve(sizes[dominated]);
+            collectInOrder(dominated, keys);
+            rebuildSubtree(dominated, keys);
+        }
+    } catch (...) {
+        // out of memory: keep the tombstones, the next remove on the path retries
+    }
+    return value;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::compact() {
+    if (tombstoneCount > 0) {
+        rebuildAll();
+    }
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::buildFromSorted(const T *keys, size_t n) {
+    if (!std::is_sorted(keys, keys + n)) {
+        throw std::runtime_error("keys are not sorted.");
+    }
+    if (std::binary_search(keys, keys + n, initValue)) {
+        throw std::runtime_error("initValue marks empty slots and cannot be a key.");
+    }
+    layOutSorted(keys, n, 1);
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::bulkLoad(const T *keys, size_t n, size_t threads) {
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    std::vector<T> sorted(keys, keys + n);
+    parallelSort(sorted, threads);
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    if (std::binary_search(sorted.begin(), sorted.end(), initValue)) {
+        throw std::runtime_error("initValue marks empty slots and cannot be a key.");
+    }
+    layOutSorted(sorted.data(), sorted.size(), threads);
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::layOutSorted(const T *keys, size_t n, size_t threads) {
+    // build aside, the current tree survives a failed allocation
+    size_t newCapacity = std::max(n, SIZE);
+    std::vector<uint64_t> tempOccupancy(wordsFor(newCapacity));
+    std::vector<uint64_t> tempTombstones(wordsFor(newCapacity));
+    std::vector<size_t> tempSizes(newCapacity + 1);
+    std::vector<size_t> tempTombstoneSizes(newCapacity + 1);
+    T *temp = new T[newCapacity + 1];
+    temp[0] = initValue;
+    std::fill_n(temp + n + 1, newCapacity - n, initValue);
+
+    // the subtrees of level topLevels + 1 are the tasks, a few per thread so uneven ones even
+    // out; the nodes above them are written here
+    size_t topLevels = 0;
+    while (threads > 1 && (size_t {1} << topLevels) < 4 * threads && (size_t {1} << topLevels) <= n) {
+        topLevels++;
+    }
+    size_t firstTask = size_t {1} << topLevels;
+    for (size_t index = 1; index < firstTask && index <= n; ++index) {
+        temp[index] = keys[completeKeysBefore(index, n) + completeSubtreeSize(2 * index, n)];
+    }
+    size_t tasks = n < firstTask ? 0 : std::min(firstTask, n - firstTask + 1);
+    // the subtrees are disjoint index ranges on every level, the threads write apart
+    parallelFor(tasks, threads, [temp, &tempSizes, keys, n, firstTask](size_t task) {
+        size_t root = firstTask + task;
+        size_t m = completeSubtreeSize(root, n);
+        fillInOrder(temp, root, keys + completeKeysBefore(root, n), m);
+        fillSizes(tempSizes, root, m);
+    });
+    for (size_t index = std::min(firstTask - 1, n); index > 0; --index) {
+        tempSizes[index] = 1 + (2 * index <= n ? tempSizes[2 * index] : 0)
+                           + (2 * index + 1 <= n ? tempSizes[2 * index + 1] : 0);
+    }
+    markComplete(tempOccupancy, rootId, n);
+
+    delete[] bst;
+    bst = temp;
+    count = n;
+    capacity = newCapacity;
+    maxCount = n;
+    occupancy = std::move(tempOccupancy);
+    tombstones = std::move(tempTombstones);
+    tombstoneCount = 0;
+    sizes = std::move(tempSizes);
+    tombstoneSizes = std::move(tempTombstoneSizes);
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+T ArrayBST<T, initValue, SIZE, BALANCED>::searchByValue(T value) {
+    if (tombstoneCount > 0) {
+        // a removed node may shadow a live one with the same value
+        return contains(value) ? value : -1;
+    }
     // keep reference to current index
     size_t curr = rootId;
     // traverse root's appropriate subtree
@@ -368,86 +864,216 @@ T ArrayBST<T, initValue, SIZE>::searchByValue(T value) {
     return -1;
 }
 
-// four types of tree traversal: preOrder, inOrder, postOrder, levelOrder
-template<typename T, T initValue, size_t SIZE>
-void ArrayBST<T, initValue, SIZE>::preOrder(size_t index) {
-    if (index > capacity || bst[index] == initValue) {
-        return;
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+std::optional<T> ArrayBST<T, initValue, SIZE, BALANCED>::lowerBound(T value) const noexcept {
+    size_t best = lowerBoundIndex(value);
+    // skip removed nodes, the next live one in order is the answer
+    while (best != 0 && tombstoneCount > 0 && isTombstone(best)) {
+        best = successorIndex(best, rootId);
+    }
+    if (best == 0) {
+        return std::nullopt;
     }
+    return bst[best];
+}
 
-    // visit and print the current node
-    cout << bst[index] << " ";
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+bool ArrayBST<T, initValue, SIZE, BALANCED>::contains(T value) const noexcept {
+    std::optional<T> ret = lowerBound(value);
+    return ret && *ret == value;
+}
 
-    // visit left child
-    preOrder(index * 2);
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::rank(T value) const noexcept {
+    return countBelow(value, false);
+}
 
-    // visit right child
-    preOrder(index * 2 + 1);
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::countInRange(T lo, T hi) const noexcept {
+    if (hi < lo) {
+        return 0;
+    }
+    return countBelow(hi, true) - countBelow(lo, false);
 }
 
-template<typename T, T initValue, size_t SIZE>
-void ArrayBST<T, initValue, SIZE>::inOrder(size_t index) {
-    if (index > capacity || bst[index] == initValue) {
-        return;
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+T ArrayBST<T, initValue, SIZE, BALANCED>::select(size_t k) const {
+    if (k >= count) {
+        throw std::runtime_error("k is out of range.");
+    }
+    size_t curr = rootId;
+    while (true) {
+        size_t leftSize = subtreeSize(curr * 2);
+        if (k < leftSize) {
+            curr = curr * 2;
+            continue;
+        }
+        k -= leftSize;
+        if (!isTombstone(curr)) {
+            if (k == 0) {
+                return bst[curr];
+            }
+            k--;
+        }
+        curr = curr * 2 + 1;
+    }
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+template<typename OutputIt>
+OutputIt ArrayBST<T, initValue, SIZE, BALANCED>::collectRange(T lo, T hi, OutputIt out) const {
+    if (hi < lo) {
+        return out;
+    }
+    for (size_t curr = lowerBoundIndex(lo); curr != 0 && !(hi < bst[curr]); curr = successorIndex(curr, rootId)) {
+        if (!isTombstone(curr)) {
+            *out++ = bst[curr];
+        }
     }
+    return out;
+}
 
-    // visit left child first
-    inOrder(index * 2);
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+StaticKaryTree<T> ArrayBST<T, initValue, SIZE, BALANCED>::freeze() const {
+    std::vector<T> keys;
+    keys.reserve(count);
+    forEachInOrder([&keys](const T &value) { keys.push_back(value); });
+    return StaticKaryTree<T>(keys.data(), keys.size());
+}
 
-    // visit and print the current node
-    cout << bst[index] << " ";
+// four types of tree traversal: preOrder, inOrder, postOrder, levelOrder
+// each prints the live nodes of the subtree at index
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::preOrder(size_t index) {
+    forEachPreOrder([](const T &value) { cout << value << " "; }, index);
+}
 
-    // visit right child
-    inOrder(index * 2 + 1);
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::inOrder(size_t index) {
+    forEachInOrder([](const T &value) { cout << value << " "; }, index);
 }
 
-template<typename T, T initValue, size_t SIZE>
-void ArrayBST<T, initValue, SIZE>::postOrder(size_t index) {
-    if (index > capacity || bst[index] == initValue) {
-        return;
-    }
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::postOrder(size_t index) {
+    forEachPostOrder([](const T &value) { cout << value << " "; }, index);
+}
 
-    // visit left child
-    postOrder(index * 2);
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::levelOrder(size_t index) {
+    forEachLevelOrder([](const T &value) { cout << value << " "; }, index);
+}
 
-    // visit right child
-    postOrder(index * 2 + 1);
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+template<typename Visitor>
+bool ArrayBST<T, initValue, SIZE, BALANCED>::forEachPreOrder(Visitor visitor, size_t index) const {
+    if (!hasNode(index)) {
+        return true;
+    }
+    for (size_t curr = index; curr != 0; curr = preOrderNext(curr, index)) {
+        if (!isTombstone(curr) && !proceed(visitor, bst[curr])) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    // visit and print the current node
-    cout << bst[index] << " ";
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+template<typename Visitor>
+bool ArrayBST<T, initValue, SIZE, BALANCED>::forEachInOrder(Visitor visitor, size_t index) const {
+    if (!hasNode(index)) {
+        return true;
+    }
+    // start at the leftmost node
+    size_t curr = index;
+    while (hasNode(curr * 2)) {
+        curr = curr * 2;
+    }
+    for (; curr != 0; curr = successorIndex(curr, index)) {
+        if (!isTombstone(curr) && !proceed(visitor, bst[curr])) {
+            return false;
+        }
+    }
+    return true;
 }
 
-template<typename T, T initValue, size_t SIZE>
-void ArrayBST<T, initValue, SIZE>::levelOrder(size_t index) {
-    if (index > capacity || bst[index] == initValue) {
-        return;
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+template<typename Visitor>
+bool ArrayBST<T, initValue, SIZE, BALANCED>::forEachPostOrder(Visitor visitor, size_t index) const {
+    if (!hasNode(index)) {
+        return true;
+    }
+    for (size_t curr = postOrderFirst(index); curr != 0; curr = postOrderNext(curr, index)) {
+        if (!isTombstone(curr) && !proceed(visitor, bst[curr])) {
+            return false;
+        }
     }
+    return true;
+}
 
-    for (size_t level = 1; level <= getHeight(); ++level) {
-        for (size_t i = std::pow(2, level - 1); i < std::pow(2, level); ++i) {
-            cout << bst[i] << " ";
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+template<typename Visitor>
+bool ArrayBST<T, initValue, SIZE, BALANCED>::forEachLevelOrder(Visitor visitor, size_t index) const {
+    if (!hasNode(index)) {
+        return true;
+    }
+    // level k of the subtree is the index range [index * 2^k, index * 2^k + 2^k)
+    for (size_t first = index, width = 1; first <= capacity; first *= 2, width *= 2) {
+        bool proceeding = forEachOccupied(first, first + width, [this, &visitor](size_t curr) {
+            return isTombstone(curr) || proceed(visitor, bst[curr]);
+        });
+        if (!proceeding) {
+            return false;
         }
     }
+    return true;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+typename ArrayBST<T, initValue, SIZE, BALANCED>::Iterator ArrayBST<T, initValue, SIZE, BALANCED>::begin() const {
+    if (isEmpty()) {
+        return end();
+    }
+    // the leftmost node, or the first live one after it
+    size_t curr = rootId;
+    while (hasNode(curr * 2)) {
+        curr = curr * 2;
+    }
+    while (isTombstone(curr)) {
+        curr = successorIndex(curr, rootId);
+    }
+    return Iterator(this, curr);
 }
 
-template<typename T, T initValue, size_t SIZE>
-int ArrayBST<T, initValue, SIZE>::getHeight() {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+typename ArrayBST<T, initValue, SIZE, BALANCED>::Iterator ArrayBST<T, initValue, SIZE, BALANCED>::end() const {
+    return Iterator(this, 0);
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+std::reverse_iterator<typename ArrayBST<T, initValue, SIZE, BALANCED>::Iterator> ArrayBST<T, initValue, SIZE, BALANCED>::rbegin() const {
+    return std::reverse_iterator<Iterator>(end());
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+std::reverse_iterator<typename ArrayBST<T, initValue, SIZE, BALANCED>::Iterator> ArrayBST<T, initValue, SIZE, BALANCED>::rend() const {
+    return std::reverse_iterator<Iterator>(begin());
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+int ArrayBST<T, initValue, SIZE, BALANCED>::getHeight() {
     if (isEmpty()) {
         return 0;
     }
-    // find the maximum index with non-initValue
-    int maximumIndex = 1;
-    for (int i = static_cast<int>(capacity); i >= 1; --i) {
-        if (bst[i] != initValue)  {
-            maximumIndex = i;
-            break;
-        }
+    // the maximum occupied index is in the last non-empty word
+    size_t w = occupancy.size() - 1;
+    while (occupancy[w] == 0) {
+        --w;
     }
-    return static_cast<int>(std::floor(std::log2(maximumIndex)) + 1);
+    return static_cast<int>(levelOf(w * WORD_BITS + highestBit(occupancy[w])));
 }
 
-template<typename T, T initValue, size_t SIZE>
-T ArrayBST<T, initValue, SIZE>::getRootValue() {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+T ArrayBST<T, initValue, SIZE, BALANCED>::getRootValue() {
     if (isEmpty()) {
         throw std::runtime_error("current BST is empty.");
     }
@@ -456,18 +1082,28 @@ T ArrayBST<T, initValue, SIZE>::getRootValue() {
 
 
 /////////////////////// Auxiliary Functions ////////////////////////
-template<typename T, T initValue, size_t SIZE>
-bool ArrayBST<T, initValue, SIZE>::isEmpty() const {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+bool ArrayBST<T, initValue, SIZE, BALANCED>::isEmpty() const {
     return count == 0;
 }
 
-template<typename T, T initValue, size_t SIZE>
-size_t ArrayBST<T, initValue, SIZE>::countNodes() const {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::countNodes() const {
     return count;
 }
 
-template<typename T, T initValue, size_t SIZE>
-void ArrayBST<T, initValue, SIZE>::visualizeBST() {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::getCapacity() const {
+    return capacity;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::countTombstones() const {
+    return tombstoneCount;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::visualizeBST() {
     // create a dummy class containing 4 functions for tree visualization
     class dummy {
     public:
@@ -524,92 +1160,619 @@ void ArrayBST<T, initValue, SIZE>::visualizeBST() {
     treeVisulizer.print(rootId, 1);
 }
 
-template<typename T, T initValue, size_t SIZE>
-T ArrayBST<T, initValue, SIZE>::minValue() {
-    if (isEmpty()) {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+T ArrayBST<T, initValue, SIZE, BALANCED>::minValue() {
+    std::optional<T> ret = tryMinValue();
+    if (!ret) {
         throw std::runtime_error("BST is empty.");
     }
+    return *ret;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+T ArrayBST<T, initValue, SIZE, BALANCED>::maxValue() {
+    std::optional<T> ret = tryMaxValue();
+    if (!ret) {
+        throw std::runtime_error("BST is empty.");
+    }
+    return *ret;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+std::optional<T> ArrayBST<T, initValue, SIZE, BALANCED>::tryMinValue() const noexcept {
+    if (isEmpty()) {
+        return std::nullopt;
+    }
     size_t curr = rootId;
     while (curr * 2 <= capacity && bst[curr * 2] != initValue) {
         // go to left child
         curr = curr * 2;
     }
+    // skip removed nodes, there is a live one since the tree is not empty
+    while (isTombstone(curr)) {
+        curr = successorIndex(curr, rootId);
+    }
     return bst[curr];
 }
 
-template<typename T, T initValue, size_t SIZE>
-T ArrayBST<T, initValue, SIZE>::maxValue() {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+std::optional<T> ArrayBST<T, initValue, SIZE, BALANCED>::tryMaxValue() const noexcept {
     if (isEmpty()) {
-        throw std::runtime_error("BST is empty.");
+        return std::nullopt;
     }
     size_t curr = rootId;
     while (curr * 2 + 1 <= capacity && bst[curr * 2 + 1] != initValue) {
         // go to right child
         curr = curr * 2 + 1;
     }
+    while (isTombstone(curr)) {
+        curr = predecessorIndex(curr, rootId);
+    }
     return bst[curr];
 }
 
 /////////////////////// Auxiliary Function ///////////////////////
-template<typename T, T initValue, size_t SIZE>
-void ArrayBST<T, initValue, SIZE>::destroyTree() {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::destroyTree() {
     delete[] bst;
     bst = nullptr;
     count = 0;
     capacity = 0;
+    occupancy.clear();
+    tombstones.clear();
+    tombstoneCount = 0;
+    sizes.clear();
+    tombstoneSizes.clear();
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::prefetch(const T *address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void) address;
+#endif
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::setSlot(size_t index, const T &value) {
+    bst[index] = value;
+    uint64_t mask = uint64_t {1} << (index % WORD_BITS);
+    if (value != initValue) {
+        occupancy[index / WORD_BITS] |= mask;
+    } else {
+        occupancy[index / WORD_BITS] &= ~mask;
+        sizes[index] = 0;
+        tombstoneSizes[index] = 0;
+    }
+    tombstones[index / WORD_BITS] &= ~mask;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::incrementSizes(size_t index) {
+    for (; index != 0; index /= 2) {
+        sizes[index]++;
+    }
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::decrementSizes(size_t index) {
+    for (; index != 0; index /= 2) {
+        sizes[index]--;
+    }
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::shiftTombstoneSizes(size_t index, std::ptrdiff_t delta) {
+    for (; index != 0; index /= 2) {
+        tombstoneSizes[index] += delta;
+    }
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::setTombstone(size_t index) {
+    tombstones[index / WORD_BITS] |= uint64_t {1} << (index % WORD_BITS);
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::findLiveIndex(T value) const noexcept {
+    // equal values may sit on both sides of a rebuilt node, so start from the first one in order
+    size_t curr = lowerBoundIndex(value);
+    while (curr != 0 && bst[curr] == value && isTombstone(curr)) {
+        curr = successorIndex(curr, rootId);
+    }
+    return curr != 0 && bst[curr] == value ? curr : 0;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::countBelow(T value, bool inclusive) const noexcept {
+    // left <= node <= right: a node below value brings its whole left subtree along
+    size_t ret = 0;
+    size_t curr = rootId;
+    while (curr <= capacity && bst[curr] != initValue) {
+        bool below = inclusive ? !(value < bst[curr]) : bst[curr] < value;
+        if (below) {
+            ret += subtreeSize(curr * 2) + (isTombstone(curr) ? 0 : 1);
+            curr = curr * 2 + 1;
+        } else {
+            curr = curr * 2;
+        }
+    }
+    return ret;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+bool ArrayBST<T, initValue, SIZE, BALANCED>::isTombstone(size_t index) const {
+    return (tombstones[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+template<typename Visitor>
+bool ArrayBST<T, initValue, SIZE, BALANCED>::forEachOccupied(size_t begin, size_t end, Visitor visit) const {
+    end = std::min(end, capacity + 1);
+    while (begin < end) {
+        size_t w = begin / WORD_BITS;
+        size_t wordEnd = std::min((w + 1) * WORD_BITS, end);
+        // the bits of [begin, wordEnd), read up front so visit may write to the word
+        uint64_t bits = occupancy[w] >> (begin % WORD_BITS);
+        if (wordEnd - begin < WORD_BITS) {
+            bits &= (uint64_t {1} << (wordEnd - begin)) - 1;
+        }
+        while (bits != 0) {
+            size_t index = begin + lowestBit(bits);
+            if constexpr (std::is_same<decltype(visit(index)), bool>::value) {
+                if (!visit(index)) {
+                    return false;
+                }
+            } else {
+                visit(index);
+            }
+            bits &= bits - 1;
+        }
+        begin = wordEnd;
+    }
+    return true;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+bool ArrayBST<T, initValue, SIZE, BALANCED>::hasNode(size_t index) const {
+    return index <= capacity && bst[index] != initValue;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::successorIndex(size_t index, size_t root) const {
+    if (hasNode(2 * index + 1)) {
+        // leftmost node of the right subtree
+        index = 2 * index + 1;
+        while (hasNode(2 * index)) {
+            index = 2 * index;
+        }
+        return index;
+    }
+    // first ancestor reached from a left child
+    while (index % 2 == 1 && index != root) {
+        index /= 2;
+    }
+    return index == root ? 0 : index / 2;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::predecessorIndex(size_t index, size_t root) const {
+    if (hasNode(2 * index)) {
+        // rightmost node of the left subtree
+        index = 2 * index;
+        while (hasNode(2 * index + 1)) {
+            index = 2 * index + 1;
+        }
+        return index;
+    }
+    // first ancestor reached from a right child
+    while (index % 2 == 0 && index != root) {
+        index /= 2;
+    }
+    return index == root ? 0 : index / 2;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::preOrderNext(size_t index, size_t root) const {
+    if (hasNode(2 * index)) {
+        return 2 * index;
+    }
+    if (hasNode(2 * index + 1)) {
+        return 2 * index + 1;
+    }
+    // climb to the nearest left child whose right sibling is still to come
+    while (index != root) {
+        if (index % 2 == 0 && hasNode(index + 1)) {
+            return index + 1;
+        }
+        index /= 2;
+    }
+    return 0;
 }
 
-template<typename T, T initValue, size_t SIZE>
-void ArrayBST<T, initValue, SIZE>::doublesize() {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::postOrderFirst(size_t root) const {
+    size_t index = root;
+    while (true) {
+        if (hasNode(2 * index)) {
+            index = 2 * index;
+        } else if (hasNode(2 * index + 1)) {
+            index = 2 * index + 1;
+        } else {
+            return index;
+        }
+    }
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::postOrderNext(size_t index, size_t root) const {
+    if (index == root) {
+        return 0;
+    }
+    // a left child is followed by its sibling's subtree, a right child by the parent
+    if (index % 2 == 0 && hasNode(index + 1)) {
+        return postOrderFirst(index + 1);
+    }
+    return index / 2;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+template<typename Visitor>
+bool ArrayBST<T, initValue, SIZE, BALANCED>::proceed(Visitor &visitor, const T &value) {
+    if constexpr (std::is_same<decltype(visitor(value)), bool>::value) {
+        return visitor(value);
+    } else {
+        visitor(value);
+        return true;
+    }
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::lowerBoundIndex(T value) const noexcept {
+    // the answer is the last node the descent turned left at, 0 while there is none
+    size_t best = 0;
+    size_t curr = rootId;
+    while (curr <= capacity && bst[curr] != initValue) {
+        // the descendants PREFETCH_LEVELS levels down sit next to each other, one fetch covers them
+        prefetch(bst + std::min(curr << PREFETCH_LEVELS, capacity));
+        // no branch on the comparison, it is unpredictable by nature
+        bool goRight = bst[curr] < value;
+        best = goRight ? best : curr;
+        curr = 2 * curr + goRight;
+    }
+    return best;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::wordsFor(size_t capacity) {
+    return capacity / WORD_BITS + 1;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::highestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return WORD_BITS - 1 - __builtin_clzll(word);
+#else
+    size_t bit = 0;
+    while (word >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    size_t bit = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::copyOccupied(const T *from, const std::vector<uint64_t> &occupied,
+                                                          size_t capacity, T *to) {
+    for (size_t w = 0; w < occupied.size(); ++w) {
+        if (occupied[w] != 0) {
+            size_t begin = w * WORD_BITS;
+            size_t end = std::min(begin + WORD_BITS, capacity + 1);
+            std::copy(from + begin, from + end, to + begin);
+        }
+    }
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::fillInOrder(T *tree, size_t root, const T *keys, size_t n) {
+    // walk the relative indices 1..n of a complete tree in order, index follows
+    // the same node at its position below root
+    // start at the leftmost node
+    size_t curr = 1;
+    size_t index = root;
+    while (2 * curr <= n) {
+        curr = 2 * curr;
+        index = 2 * index;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        tree[index] = keys[i];
+        if (2 * curr + 1 <= n) {
+            // successor is the leftmost node of the right subtree
+            curr = 2 * curr + 1;
+            index = 2 * index + 1;
+            while (2 * curr <= n) {
+                curr = 2 * curr;
+                index = 2 * index;
+            }
+        } else {
+            // successor is the first ancestor reached from a left child
+            while (curr % 2 == 1) {
+                curr /= 2;
+                index /= 2;
+            }
+            curr /= 2;
+            index /= 2;
+        }
+    }
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::markComplete(std::vector<uint64_t> &occupied, size_t root, size_t n) {
+    // level k of the shape is a run of up to 2^k indices from root * 2^k, set word by word
+    for (size_t first = root, width = 1; n > 0; first *= 2, width *= 2) {
+        size_t end = first + std::min(width, n);
+        n -= std::min(width, n);
+        for (size_t begin = first; begin < end;) {
+            size_t wordEnd = std::min((begin / WORD_BITS + 1) * WORD_BITS, end);
+            uint64_t bits = wordEnd - begin == WORD_BITS ? ~uint64_t {0} : (uint64_t {1} << (wordEnd - begin)) - 1;
+            occupied[begin / WORD_BITS] |= bits << (begin % WORD_BITS);
+            begin = wordEnd;
+        }
+    }
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::completeSubtreeSize(size_t index, size_t n) {
+    // the shape fills the indices 1..n, level k of the subtree is [index * 2^k, index * 2^k + 2^k)
+    size_t ret = 0;
+    for (size_t first = index, width = 1; first <= n; first *= 2, width *= 2) {
+        ret += std::min(first + width - 1, n) - first + 1;
+    }
+    return ret;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::completeKeysBefore(size_t index, size_t n) {
+    // a right child comes after its parent and the parent's left subtree
+    size_t ret = 0;
+    for (; index > 1; index /= 2) {
+        if (index % 2 == 1) {
+            ret += completeSubtreeSize(index - 1, n) + 1;
+        }
+    }
+    return ret;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+template<typename Work>
+void ArrayBST<T, initValue, SIZE, BALANCED>::parallelFor(size_t tasks, size_t threads, Work work) {
+    std::atomic<size_t> next {0};
+    auto worker = [&next, tasks, &work]() {
+        for (size_t task = next++; task < tasks; task = next++) {
+            work(task);
+        }
+    };
+    std::vector<std::thread> helpers;
+    try {
+        for (size_t t = 1; t < std::min(threads, tasks); ++t) {
+            helpers.emplace_back(worker);
+        }
+    } catch (...) {
+        // out of threads: the ones started and this one share the tasks
+    }
+    worker();
+    for (std::thread &helper : helpers) {
+        helper.join();
+    }
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::parallelSort(std::vector<T> &keys, size_t threads) {
+    // runs of the chunk size, the last one shorter
+    size_t chunks = std::max<size_t>(1, std::min(threads, keys.size() / 4096));
+    size_t width = (keys.size() + chunks - 1) / chunks;
+    parallelFor(chunks, threads, [&keys, width](size_t chunk) {
+        std::sort(keys.begin() + std::min(chunk * width, keys.size()), keys.begin() + std::min((chunk + 1) * width, keys.size()));
+    });
+    for (; width < keys.size(); width *= 2) {
+        size_t pairs = (keys.size() + 2 * width - 1) / (2 * width);
+        parallelFor(pairs, threads, [&keys, width](size_t pair) {
+            size_t begin = pair * 2 * width;
+            size_t middle = std::min(begin + width, keys.size());
+            size_t end = std::min(begin + 2 * width, keys.size());
+            std::inplace_merge(keys.begin() + begin, keys.begin() + middle, keys.begin() + end);
+        });
+    }
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::fillSizes(std::vector<size_t> &sizes, size_t root, size_t n) {
+    // children before parents: relative index r on level k of the shape sits at root * 2^k + r - 2^k
+    for (size_t r = n; r > 0; --r) {
+        size_t level = levelOf(r) - 1;
+        size_t index = (root << level) + r - (size_t {1} << level);
+        sizes[index] = 1 + (2 * r <= n ? sizes[2 * index] : 0) + (2 * r + 1 <= n ? sizes[2 * index + 1] : 0);
+    }
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::levelOf(size_t index) {
+    size_t level = 0;
+    while (index > 0) {
+        level++;
+        index /= 2;
+    }
+    return level;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::subtreeSize(size_t index) const {
+    return index <= capacity ? sizes[index] : 0;
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::collectInOrder(size_t index, std::vector<T> &out) const {
+    if (index > capacity || bst[index] == initValue) {
+        return;
+    }
+    collectInOrder(index * 2, out);
+    if (!isTombstone(index)) {
+        out.push_back(bst[index]);
+    }
+    collectInOrder(index * 2 + 1, out);
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::clearSubtree(size_t index) {
+    if (index > capacity || bst[index] == initValue) {
+        return;
+    }
+    if (isTombstone(index)) {
+        tombstoneCount--;
+    }
+    setSlot(index, initValue);
+    clearSubtree(index * 2);
+    clearSubtree(index * 2 + 1);
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::fillBalanced(size_t index, const T *keys, size_t n) {
+    if (n == 0) {
+        return;
+    }
+    size_t left = (n - 1) / 2;
+    setSlot(index, keys[left]);
+    sizes[index] = n;
+    fillBalanced(index * 2, keys, left);
+    fillBalanced(index * 2 + 1, keys + left + 1, n - 1 - left);
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::balancedLevels(size_t n) {
+    return 1 + static_cast<size_t>(std::log(static_cast<double>(n)) / std::log(1 / BALANCE_ALPHA));
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::rebuildForInsert(size_t slot, T value) {
+    // climb from the empty slot, counting the value as already there, to the first ancestor
+    // with a child heavier than alpha of it; a path deeper than balancedLevels(count + 1) passes
+    // one, unless tombstones hold the tree up, then the root is rebuilt
+    // sizes count live nodes only, the rebuild drops tombstones
+    size_t child = slot;
+    size_t childSize = 1;
+    size_t node = child / 2;
+    size_t nodeSize = (isTombstone(node) ? 0 : 1) + childSize + subtreeSize(child ^ 1);
+    while (node != rootId && std::max(childSize, subtreeSize(child ^ 1)) <= BALANCE_ALPHA * nodeSize) {
+        child = node;
+        childSize = nodeSize;
+        node = child / 2;
+        nodeSize = (isTombstone(node) ? 0 : 1) + childSize + subtreeSize(child ^ 1);
+    }
+
+    // take the subtree out in order, equal values go right as in insert
+    std::vector<T> keys;
+    keys.reserve(nodeSize);
+    collectInOrder(node, keys);
+    keys.insert(std::upper_bound(keys.begin(), keys.end(), value), value);
+
+    rebuildSubtree(node, keys);
+    // the ancestors gain the new value, the dropped tombstones were never counted
+    incrementSizes(node / 2);
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::rebuildSubtree(size_t node, const std::vector<T> &keys) {
+    // right halves are never the smaller one, the rightmost path is the deepest
+    size_t lastId = node;
+    for (size_t n = keys.size() / 2; n > 0; n /= 2) {
+        lastId = 2 * lastId + 1;
+    }
+    while (lastId > capacity) {
+        doublesize();
+    }
+
+    size_t dropped = tombstoneSizes[node];
+    clearSubtree(node);
+    fillBalanced(node, keys.data(), keys.size());
+    shiftTombstoneSizes(node / 2, -static_cast<std::ptrdiff_t>(dropped));
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::rebuildAll() {
+    std::vector<T> keys;
+    keys.reserve(count);
+    collectInOrder(rootId, keys);
+    buildFromSorted(keys.data(), keys.size());
+}
+
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::doublesize() {
     size_t doubleCapacity = 2 * capacity;
+    occupancy.resize(wordsFor(doubleCapacity));
+    tombstones.resize(wordsFor(doubleCapacity));
+    sizes.resize(doubleCapacity + 1);
+    tombstoneSizes.resize(doubleCapacity + 1);
 
     // allocate new array
     T *temp = this->bst;
     this->bst = new T[doubleCapacity + 1];
     std::fill_n(this->bst, doubleCapacity + 1, initValue);
 
-    // element-wise copy
-    for (size_t i = 0; i <= capacity; ++i) {
-        // whether shallow copy or deep copy depends on behavior on overloaded operator= in T
-        if (temp[i] != initValue) {
-            this->bst[i] = temp[i];
-        }
-    }
+    // copy only the words holding nodes
+    // whether shallow copy or deep copy depends on behavior on overloaded operator= in T
+    copyOccupied(temp, occupancy, capacity, this->bst);
     capacity = doubleCapacity;
 
     // de-allocation
     delete[] temp;
 }
 
-template<typename T, T initValue, size_t SIZE>
-void ArrayBST<T, initValue, SIZE>::reorganizeSubtree(size_t subtreeRootIndex, size_t subtreeRootIndexMoveTo) {
-    if (subtreeRootIndex > capacity) {
-        return;
-    }
-    bst[subtreeRootIndex] = initVal;
-    size_t leftChildIndex = 2 * subtreeRootIndex;
-    size_t rightChildIndex = 2 * subtreeRootIndex + 1;
-
-    // update left subtree
-    if (leftChildIndex <= capacity && bst[leftChildIndex] != initVal) {
-        bst[subtreeRootIndexMoveTo * 2] = bst[leftChildIndex];
-        // set current to initValue
-        bst[leftChildIndex] = initValue;
-        // update left subtree recursively
-        reorganizeSubtree(leftChildIndex, subtreeRootIndexMoveTo * 2);
-    }
-    // update right subtree
-    if (rightChildIndex <= capacity && bst[rightChildIndex] != initVal) {
-        bst[subtreeRootIndexMoveTo * 2 + 1] = bst[rightChildIndex];
-        // set current to initValue
-        bst[rightChildIndex] = initValue;
-        // update right subtree recursively
-        reorganizeSubtree(rightChildIndex, subtreeRootIndexMoveTo * 2 + 1);
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+void ArrayBST<T, initValue, SIZE, BALANCED>::reorganizeSubtree(size_t subtreeRootIndex, size_t subtreeRootIndexMoveTo) {
+    // level k of the subtree spans [from, from + width) and moves to [to, to + width); the target
+    // is the level moved the round before plus the same level of the empty sibling subtree
+    size_t from = subtreeRootIndex;
+    size_t to = subtreeRootIndexMoveTo;
+    for (size_t width = 1; to <= capacity; width *= 2) {
+        // clear what is left of the level moved the round before
+        forEachOccupied(to, to + width, [this](size_t index) {
+            setSlot(index, initValue);
+        });
+        bool moved = false;
+        forEachOccupied(from, from + width, [this, from, to, &moved](size_t index) {
+            setSlot(to + (index - from), bst[index]);
+            if (isTombstone(index)) {
+                setTombstone(to + (index - from));
+            }
+            sizes[to + (index - from)] = sizes[index];
+            tombstoneSizes[to + (index - from)] = tombstoneSizes[index];
+            moved = true;
+        });
+        if (!moved) {
+            return;
+        }
+        from *= 2;
+        to *= 2;
     }
 }
 
-template<typename T, T initValue, size_t SIZE>
-size_t ArrayBST<T, initValue, SIZE>::findMinimumIndex(size_t currentIndex) {
+template<typename T, T initValue, size_t SIZE, bool BALANCED>
+size_t ArrayBST<T, initValue, SIZE, BALANCED>::findMinimumIndex(size_t currentIndex) {
     size_t leftChildIndex = 2 * currentIndex;
     if (leftChildIndex > capacity || bst[leftChildIndex] == initValue) {
         return currentIndex;
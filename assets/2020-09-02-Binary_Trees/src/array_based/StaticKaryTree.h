@@ -0,0 +1,400 @@
+#ifndef STATIC_KARY_TREE_H
+#define STATIC_KARY_TREE_H
+
+#include <new>
+#include <memory>
+#include <limits>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define STATIC_KARY_TREE_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * Immutable k-ary search tree over sorted keys, the read-only snapshot of an ArrayBST
+ *
+ * Every node is one cache line of B = 64 / sizeof(T) sorted keys and has B + 1 children,
+ * numbered implicitly as in a binary heap: the children of node k are k * (B + 1) + 1 up
+ * to k * (B + 1) + B + 1. A lookup reads one cache line per level, log_(B+1)(n) of them
+ * against log_2(n) for a binary layout.
+ *
+ * A node is searched by counting its keys below the query. For 32-bit integers this takes
+ * one compare and movemask, with AVX2 or SSE2 as the CPU allows, detected once at runtime.
+ * Other types and CPUs count with a scalar loop.
+ *
+ * @tparam T  arithmetic type
+ */
+template<typename T>
+class StaticKaryTree {
+public:
+    // the ways of searching a node
+    enum class Kernel { SCALAR, SSE2, AVX2 };
+
+    // default constructor, an empty tree
+    StaticKaryTree();
+
+    // constructor, n keys sorted ascending, duplicates allowed
+    StaticKaryTree(const T *keys, size_t n);
+
+    /////////////////////////// Big Five  ////////////////////////////
+    // 1. destructor
+    virtual ~StaticKaryTree();
+
+    // 2. copy constructor
+    StaticKaryTree(const StaticKaryTree &skt);
+
+    // 3. copy assignment operator=
+    StaticKaryTree& operator=(const StaticKaryTree &skt);
+
+    // 4. move constructor
+    StaticKaryTree(StaticKaryTree &&skt) noexcept;
+
+    // 5. move assignment operator=
+    StaticKaryTree& operator=(StaticKaryTree &&skt) noexcept;
+
+    //////////////////////////////////////////////////////////////////
+
+    ////////////////////// Principle Operations //////////////////////
+    // smallest key >= value, std::nullopt if there is none
+    std::optional<T> lowerBound(T value) const noexcept;
+
+    bool contains(T value) const noexcept;
+
+    //////////////////////////////////////////////////////////////////
+
+    ////////////////////// Auxiliary Operations //////////////////////
+    bool isEmpty() const;
+
+    size_t size() const;
+
+    // the best kernel the CPU supports for T unless set otherwise
+    Kernel getKernel() const;
+
+    // throws if the CPU or T does not support kernel
+    void setKernel(Kernel kernel);
+
+    static bool supports(Kernel kernel);
+
+    //////////////////////////////////////////////////////////////////
+
+private:
+    static_assert(std::is_arithmetic<T>::value, "StaticKaryTree needs arithmetic keys.");
+
+    static constexpr size_t CACHE_LINE = 64;
+
+    // keys per node
+    static constexpr size_t B = CACHE_LINE / sizeof(T);
+
+    // the SIMD kernels compare 32-bit signed integers
+    static constexpr bool SIMD_KEYS = std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4;
+
+    // blockCount nodes of B keys each, cache line aligned; the slots after the n keys in
+    // order are padded with the largest T
+    T *nodes;
+
+    size_t count;
+
+    size_t blockCount;
+
+    // the largest key, a lookup above it has no answer
+    T maxKey;
+
+    Kernel kernel;
+
+    /////////////////////// Auxiliary Function ///////////////////////
+    static T* allocate(size_t blocks);
+
+    static void deallocate(T *nodes);
+
+    static Kernel bestKernel();
+
+    // write the keys in order into the subtree at node, next is the first key left to write
+    void fill(size_t node, const T *keys, size_t n, size_t &next);
+
+    // slot of the first key >= value, one version per kernel; value is at most maxKey
+    size_t lowerBoundSlot(T value) const;
+
+    size_t searchScalar(T value) const;
+
+#ifdef STATIC_KARY_TREE_X86
+#ifdef __SSE2__
+    size_t searchSse2(T value) const;
+#endif
+
+    __attribute__((target("avx2"))) size_t searchAvx2(T value) const;
+#endif
+};
+
+/////////////////////// Function Implementation ///////////////////////
+// default constructor
+template<typename T>
+StaticKaryTree<T>::StaticKaryTree() : nodes {nullptr}, count {0}, blockCount {0}, maxKey {}, kernel {bestKernel()} {
+}
+
+// constructor
+template<typename T>
+StaticKaryTree<T>::StaticKaryTree(const T *keys, size_t n) : nodes {nullptr}, count {n}, blockCount {(n + B - 1) / B},
+                                                            maxKey {}, kernel {bestKernel()} {
+    if (!std::is_sorted(keys, keys + n)) {
+        throw std::runtime_error("keys are not sorted.");
+    }
+    if (n == 0) {
+        return;
+    }
+    maxKey = keys[n - 1];
+    nodes = allocate(blockCount);
+    size_t next = 0;
+    fill(0, keys, n, next);
+}
+
+//////////////////////////// Big Five  /////////////////////////////
+// 1. destructor
+template<typename T>
+StaticKaryTree<T>::~StaticKaryTree() {
+    deallocate(nodes);
+}
+
+// 2. copy constructor
+template<typename T>
+StaticKaryTree<T>::StaticKaryTree(const StaticKaryTree &skt) : nodes {allocate(skt.blockCount)}, count {skt.count},
+                                                              blockCount {skt.blockCount}, maxKey {skt.maxKey},
+                                                              kernel {skt.kernel} {
+    std::copy(skt.nodes, skt.nodes + blockCount * B, nodes);
+}
+
+// 3. copy assignment operator=
+template<typename T>
+StaticKaryTree<T>& StaticKaryTree<T>::operator=(const StaticKaryTree &skt) {
+    // check self-assignment
+    if (this == &skt) {
+        return *this;
+    }
+    // allocation, the current tree survives a failure
+    T *temp = allocate(skt.blockCount);
+    std::copy(skt.nodes, skt.nodes + skt.blockCount * B, temp);
+
+    deallocate(nodes);
+    nodes = temp;
+    count = skt.count;
+    blockCount = skt.blockCount;
+    maxKey = skt.maxKey;
+    kernel = skt.kernel;
+
+    return *this;
+}
+
+// 4. move constructor
+template<typename T>
+StaticKaryTree<T>::StaticKaryTree(StaticKaryTree &&skt) noexcept : nodes {skt.nodes}, count {skt.count},
+                                                                  blockCount {skt.blockCount}, maxKey {skt.maxKey},
+                                                                  kernel {skt.kernel} {
+    // reset skt to an empty tree
+    skt.nodes = nullptr;
+    skt.count = 0;
+    skt.blockCount = 0;
+}
+
+// 5. move assignment operator=
+template<typename T>
+StaticKaryTree<T>& StaticKaryTree<T>::operator=(StaticKaryTree &&skt) noexcept {
+    // check self-assignment
+    if (this == &skt) {
+        return *this;
+    }
+    deallocate(nodes);
+    nodes = skt.nodes;
+    count = skt.count;
+    blockCount = skt.blockCount;
+    maxKey = skt.maxKey;
+    kernel = skt.kernel;
+
+    // reset skt to an empty tree
+    skt.nodes = nullptr;
+    skt.count = 0;
+    skt.blockCount = 0;
+
+    return *this;
+}
+
+/////////////////////// Principle Operations ///////////////////////
+template<typename T>
+std::optional<T> StaticKaryTree<T>::lowerBound(T value) const noexcept {
+    if (isEmpty() || maxKey < value) {
+        return std::nullopt;
+    }
+    // a key >= value exists and the padding comes after every key, so the slot holds a key
+    return nodes[lowerBoundSlot(value)];
+}
+
+template<typename T>
+bool StaticKaryTree<T>::contains(T value) const noexcept {
+    std::optional<T> ret = lowerBound(value);
+    return ret && *ret == value;
+}
+
+/////////////////////// Auxiliary Operations ///////////////////////
+template<typename T>
+bool StaticKaryTree<T>::isEmpty() const {
+    return count == 0;
+}
+
+template<typename T>
+size_t StaticKaryTree<T>::size() const {
+    return count;
+}
+
+template<typename T>
+typename StaticKaryTree<T>::Kernel StaticKaryTree<T>::getKernel() const {
+    return kernel;
+}
+
+template<typename T>
+void StaticKaryTree<T>::setKernel(Kernel kernel) {
+    if (!supports(kernel)) {
+        throw std::runtime_error("kernel is not supported.");
+    }
+    this->kernel = kernel;
+}
+
+template<typename T>
+bool StaticKaryTree<T>::supports(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::SCALAR:
+            return true;
+        case Kernel::SSE2:
+#if defined(STATIC_KARY_TREE_X86) && defined(__SSE2__)
+            return SIMD_KEYS;
+#else
+            return false;
+#endif
+        case Kernel::AVX2:
+#ifdef STATIC_KARY_TREE_X86
+            return SIMD_KEYS && __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+/////////////////////// Auxiliary Function ///////////////////////
+template<typename T>
+T* StaticKaryTree<T>::allocate(size_t blocks) {
+    if (blocks == 0) {
+        return nullptr;
+    }
+    T *ret = static_cast<T *>(::operator new(blocks * CACHE_LINE, std::align_val_t {CACHE_LINE}));
+    std::uninitialized_fill_n(ret, blocks * B, T {});
+    return ret;
+}
+
+template<typename T>
+void StaticKaryTree<T>::deallocate(T *nodes) {
+    if (nodes != nullptr) {
+        ::operator delete(nodes, std::align_val_t {CACHE_LINE});
+    }
+}
+
+template<typename T>
+typename StaticKaryTree<T>::Kernel StaticKaryTree<T>::bestKernel() {
+    // checked once per T
+    static const Kernel best = supports(Kernel::AVX2) ? Kernel::AVX2
+                               : supports(Kernel::SSE2) ? Kernel::SSE2 : Kernel::SCALAR;
+    return best;
+}
+
+template<typename T>
+void StaticKaryTree<T>::fill(size_t node, const T *keys, size_t n, size_t &next) {
+    if (node >= blockCount) {
+        return;
+    }
+    // key i of the node sits between the subtrees of children i and i + 1
+    for (size_t i = 0; i < B; ++i) {
+        fill(node * (B + 1) + i + 1, keys, n, next);
+        nodes[node * B + i] = next < n ? keys[next++] : std::numeric_limits<T>::max();
+    }
+    fill(node * (B + 1) + B + 1, keys, n, next);
+}
+
+template<typename T>
+size_t StaticKaryTree<T>::lowerBoundSlot(T value) const {
+#ifdef STATIC_KARY_TREE_X86
+    if constexpr (SIMD_KEYS) {
+        // the same kernel every call, the branch is predicted
+        if (kernel == Kernel::AVX2) {
+            return searchAvx2(value);
+        }
+#ifdef __SSE2__
+        if (kernel == Kernel::SSE2) {
+            return searchSse2(value);
+        }
+#endif
+    }
+#endif
+    return searchScalar(value);
+}
+
+// the three searches below share one loop: count the keys of the node below value, the
+// first key not below is the best answer so far, and continue in the child left of it
+
+template<typename T>
+size_t StaticKaryTree<T>::searchScalar(T value) const {
+    size_t best = 0;
+    for (size_t node = 0; node < blockCount;) {
+        const T *keys = nodes + node * B;
+        size_t below = 0;
+        for (size_t i = 0; i < B; ++i) {
+            below += keys[i] < value;
+        }
+        best = below < B ? node * B + below : best;
+        node = node * (B + 1) + below + 1;
+    }
+    return best;
+}
+
+#ifdef STATIC_KARY_TREE_X86
+#ifdef __SSE2__
+template<typename T>
+size_t StaticKaryTree<T>::searchSse2(T value) const {
+    __m128i x = _mm_set1_epi32(value);
+    size_t best = 0;
+    for (size_t node = 0; node < blockCount;) {
+        const __m128i *line = reinterpret_cast<const __m128i *>(nodes + node * B);
+        // one bit per key below value
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, _mm_load_si128(line))))
+                   | _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, _mm_load_si128(line + 1)))) << 4
+                   | _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, _mm_load_si128(line + 2)))) << 8
+                   | _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, _mm_load_si128(line + 3)))) << 12;
+        // the keys are sorted, so the set bits are the lowest ones
+        size_t below = __builtin_ctz(~mask);
+        best = below < B ? node * B + below : best;
+        node = node * (B + 1) + below + 1;
+    }
+    return best;
+}
+#endif
+
+template<typename T>
+__attribute__((target("avx2"))) size_t StaticKaryTree<T>::searchAvx2(T value) const {
+    __m256i x = _mm256_set1_epi32(value);
+    size_t best = 0;
+    for (size_t node = 0; node < blockCount;) {
+        const __m256i *line = reinterpret_cast<const __m256i *>(nodes + node * B);
+        // one bit per key below value
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, _mm256_load_si256(line))))
+                   | _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, _mm256_load_si256(line + 1)))) << 8;
+        // the keys are sorted, so the set bits are the lowest ones
+        size_t below = __builtin_ctz(~mask);
+        best = below < B ? node * B + below : best;
+        node = node * (B + 1) + below + 1;
+    }
+    return best;
+}
+#endif
+
+#endif //STATIC_KARY_TREE_H
@@ -1,11 +1,17 @@
 #include <iostream>
 #include <assert.h>
 #include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <set>
+#include <limits>
+#include <ctime>
 #include "ArrayBST.h"
 
 using std::cout;
 using std::endl;
 using std::runtime_error;
+using std::vector;
 
 const int rootIndex = 1;
 
@@ -197,5 +203,501 @@ int main() {
     assert(abst_5.countNodes() == 7);
     assert(abst_5.countNodes() == 7);
 
+    // test tryMinValue, tryMaxValue, tryRemove: misses are not exceptions
+    assert(abst_3.tryMinValue().value() == 2);
+    assert(abst_3.tryMaxValue().value() == 40);
+    assert(!abst_1.tryMinValue());
+    assert(!abst_1.tryMaxValue());
+    assert(!abst_1.tryRemove(5));
+    assert(!abst_6.tryRemove(42));
+    assert(abst_6.countNodes() == 7);
+    assert(abst_6.tryRemove(9).value() == 9);
+    assert(abst_6.countNodes() == 6);
+    assert(abst_6.tryMaxValue().value() == 7);
+
+    // test buildFromSorted, lowerBound, contains against std::lower_bound
+    for (size_t n : {0, 1, 2, 3, 7, 8, 100, 1000}) {
+        vector<int> keys(n);
+        for (size_t i = 0; i < n; ++i) {
+            keys[i] = 2 * static_cast<int>(i) + 2;
+        }
+        ArrayBST<int, 0, 1> abst_7;
+        abst_7.buildFromSorted(keys.data(), keys.size());
+        assert(abst_7.countNodes() == n);
+        if (n > 0) {
+            // perfectly balanced
+            assert(abst_7.getHeight() == static_cast<int>(std::floor(std::log2(n))) + 1);
+            assert(abst_7.minValue() == keys.front());
+            assert(abst_7.maxValue() == keys.back());
+        }
+        for (int value = -1; value <= 2 * static_cast<int>(n) + 3; ++value) {
+            auto it = std::lower_bound(keys.begin(), keys.end(), value);
+            std::optional<int> ret = abst_7.lowerBound(value);
+            assert(ret.has_value() == (it != keys.end()));
+            assert(!ret || *ret == *it);
+            assert(abst_7.contains(value) == std::binary_search(keys.begin(), keys.end(), value));
+        }
+    }
+
+    // lowerBound on an insert-built tree with gaps
+    assert(abst_3.lowerBound(3).value() == 4);
+    assert(abst_3.lowerBound(35).value() == 36);
+    assert(!abst_3.lowerBound(41));
+    assert(abst_3.contains(40) == true);
+    assert(abst_3.contains(16) == false);
+
+    // inserting after a bulk build keeps both searches working
+    vector<int> keys_8 {10, 20, 30, 40, 50, 60, 70};
+    ArrayBST<int, 0, 1> abst_8;
+    abst_8.buildFromSorted(keys_8.data(), keys_8.size());
+    abst_8.insert(35);
+    assert(abst_8.countNodes() == 8);
+    assert(abst_8.searchByValue(35) == 35);
+    assert(abst_8.lowerBound(31).value() == 35);
+    assert(abst_8.lowerBound(36).value() == 40);
+
+    // unsorted keys or keys equal to initValue are rejected
+    vector<int> unsorted {3, 1, 2};
+    vector<int> withSentinel {-1, 0, 1};
+    bool thrown = false;
+    try {
+        abst_8.buildFromSorted(unsorted.data(), unsorted.size());
+    } catch (const runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+    thrown = false;
+    try {
+        abst_8.buildFromSorted(withSentinel.data(), withSentinel.size());
+    } catch (const runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+    assert(abst_8.countNodes() == 8);
+
+    // test BALANCED inserts: sorted, reverse sorted and zig-zag orders keep the depth
+    // within 1 + log_{1/0.52}(count) levels and the capacity within a few times count
+    const int balancedKeys = 5000;
+    for (int order = 0; order < 3; ++order) {
+        ArrayBST<int, 0, 1, true> abst_9;
+        for (int i = 1; i <= balancedKeys; ++i) {
+            int value = order == 0 ? i : order == 1 ? balancedKeys + 1 - i : (i % 2 == 0 ? i / 2 : balancedKeys + 1 - (i + 1) / 2);
+            abst_9.insert(value);
+            assert(abst_9.countNodes() == static_cast<size_t>(i));
+            assert(abst_9.getHeight() <= 1 + static_cast<int>(std::log(i) / std::log(1 / 0.52)));
+        }
+        assert(abst_9.getCapacity() < 4 * static_cast<size_t>(balancedKeys));
+        for (int value = 1; value <= balancedKeys; ++value) {
+            assert(abst_9.searchByValue(value) == value);
+            assert(abst_9.lowerBound(value).value() == value);
+        }
+        assert(abst_9.minValue() == 1);
+        assert(abst_9.maxValue() == balancedKeys);
+    }
+
+    // the rebuilds amortize in every order: 10^5 descending or zig-zag inserts each took over a
+    // minute when an insert past the depth limit rebuilt an ancestor high in the tree
+    for (int order = 1; order < 3; ++order) {
+        const int manyKeys = 100000;
+        std::clock_t started = std::clock();
+        ArrayBST<int, 0, 1, true> abst_9;
+        for (int i = 1; i <= manyKeys; ++i) {
+            abst_9.insert(order == 1 ? manyKeys + 1 - i : (i % 2 == 0 ? i / 2 : manyKeys + 1 - (i + 1) / 2));
+        }
+        assert(static_cast<double>(std::clock() - started) / CLOCKS_PER_SEC < 10);
+        assert(abst_9.countNodes() == static_cast<size_t>(manyKeys));
+        assert(abst_9.minValue() == 1);
+        assert(abst_9.maxValue() == manyKeys);
+    }
+
+    // test BALANCED remove: once 48% of the nodes are gone the array is rebuilt right-sized
+    // the odd keys of a perfect tree are its leaves
+    vector<int> perfectKeys((1 << 12) - 1);
+    for (size_t i = 0; i < perfectKeys.size(); ++i) {
+        perfectKeys[i] = static_cast<int>(i) + 1;
+    }
+    ArrayBST<int, 0, 1, true> abst_10;
+    abst_10.buildFromSorted(perfectKeys.data(), perfectKeys.size());
+    size_t peakCapacity = abst_10.getCapacity();
+    for (int value = 1; value <= static_cast<int>(perfectKeys.size()); value += 2) {
+        assert(abst_10.remove(rootIndex, value) == value);
+    }
+    assert(abst_10.countNodes() == (1 << 11) - 1);
+    assert(abst_10.getCapacity() < peakCapacity);
+    assert(abst_10.getHeight() <= 12);
+    for (int value = 1; value <= static_cast<int>(perfectKeys.size()); ++value) {
+        assert(abst_10.contains(value) == (value % 2 == 0));
+    }
+
+    // the unbalanced default still degenerates on sorted input
+    ArrayBST<int, 0, 1> abst_11;
+    for (int i = 1; i <= 10; ++i) {
+        abst_11.insert(i);
+    }
+    assert(abst_11.getHeight() == 10);
+    assert(abst_11.getCapacity() >= 1023);
+
+    // test copy and move, operator== compares shape and values
+    ArrayBST<int, 0, 1> abst_12(abst_2);
+    assert(abst_12 == abst_2);
+    assert(abst_12.countNodes() == 31);
+    assert(abst_12.getHeight() == 5);
+    abst_12.insert(32);
+    assert((abst_12 == abst_2) == false);
+    assert(abst_12.getHeight() == 6);
+    abst_12 = abst_4;
+    assert(abst_12 == abst_4);
+    ArrayBST<int, 0, 1> abst_13(std::move(abst_12));
+    assert(abst_13 == abst_4);
+    assert(abst_12.countNodes() == 0);
+    abst_12 = std::move(abst_13);
+    assert(abst_12 == abst_4);
+    // same count, different shape
+    ArrayBST<int, 0, 1> abst_14(5);
+    abst_14.insert(3);
+    ArrayBST<int, 0, 1> abst_15(5);
+    abst_15.insert(7);
+    assert((abst_14 == abst_15) == false);
+    // getHeight follows removes
+    abst_15.remove(rootIndex, 7);
+    assert(abst_15.getHeight() == 1);
+    abst_11.remove(rootIndex, 10);
+    assert(abst_11.getHeight() == 9);
+
+    // test remove against std::set: moving a subtree up keeps every node findable
+    const int removeKeys = 300;
+    std::set<int> reference;
+    ArrayBST<int, 0, 1> abst_16(removeKeys / 2 + 1);
+    reference.insert(removeKeys / 2 + 1);
+    unsigned seed = 7;
+    for (int i = 0; i < 200; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int value = static_cast<int>((seed >> 16) % removeKeys) + 1;
+        if (reference.insert(value).second) {
+            abst_16.insert(value);
+        }
+    }
+    while (!reference.empty()) {
+        seed = seed * 1103515245u + 12345u;
+        auto it = reference.lower_bound(static_cast<int>((seed >> 16) % removeKeys) + 1);
+        if (it == reference.end()) {
+            it = reference.begin();
+        }
+        assert(abst_16.remove(rootIndex, *it) == *it);
+        reference.erase(it);
+        assert(abst_16.countNodes() == reference.size());
+        for (int value = 1; value <= removeKeys; ++value) {
+            assert(abst_16.contains(value) == (reference.count(value) == 1));
+        }
+    }
+    assert(abst_16.isEmpty() == true);
+
+    // test lazyRemove: tombstones are skipped and compacted away where they outnumber live nodes
+    const int lazyKeys = 1000;
+    vector<int> lazySorted(lazyKeys);
+    for (int i = 0; i < lazyKeys; ++i) {
+        lazySorted[i] = 2 * i + 2;
+    }
+    ArrayBST<int, 0, 1> abst_17;
+    abst_17.buildFromSorted(lazySorted.data(), lazySorted.size());
+    reference = std::set<int>(lazySorted.begin(), lazySorted.end());
+    size_t fullCapacity = abst_17.getCapacity();
+    bool compacted = false;
+    while (reference.size() > 1) {
+        seed = seed * 1103515245u + 12345u;
+        auto it = reference.lower_bound(static_cast<int>((seed >> 16) % (2 * lazyKeys)) + 1);
+        if (it == reference.end()) {
+            it = reference.begin();
+        }
+        int value = *it;
+        size_t tombstonesBefore = abst_17.countTombstones();
+        assert(abst_17.lazyRemove(value).value() == value);
+        assert(!abst_17.lazyRemove(value));
+        reference.erase(it);
+        compacted = compacted || abst_17.countTombstones() < tombstonesBefore;
+        assert(abst_17.countNodes() == reference.size());
+        assert(abst_17.countTombstones() <= abst_17.countNodes());
+        assert(abst_17.contains(value) == false);
+        assert(abst_17.searchByValue(value) == -1);
+        assert(abst_17.minValue() == *reference.begin());
+        assert(abst_17.maxValue() == *reference.rbegin());
+        if (reference.size() % 50 == 0) {
+            for (int query = 0; query <= 2 * lazyKeys + 2; ++query) {
+                auto expected = reference.lower_bound(query);
+                std::optional<int> ret = abst_17.lowerBound(query);
+                assert(ret.has_value() == (expected != reference.end()));
+                assert(!ret || *ret == *expected);
+            }
+        }
+    }
+    assert(compacted == true);
+    assert(abst_17.getCapacity() < fullCapacity);
+
+    // insert brings a tombstone back, a subtree of mostly tombstones is rebuilt without them,
+    // remove carries tombstones along with the nodes it moves
+    //              16
+    //        8            24
+    //     4     12     20     28
+    //    2 6  10 14  18 22  26 30
+    ArrayBST<int, 0, 1> abst_18;
+    abst_18.buildFromSorted(lazySorted.data(), 15);
+    abst_18.lazyRemove(16);
+    abst_18.lazyRemove(4);
+    assert(abst_18.countTombstones() == 2);
+    abst_18.insert(16);
+    assert(abst_18.countTombstones() == 1);
+    assert(abst_18.contains(16) == true);
+    assert(abst_18.countNodes() == 14);
+    abst_18.lazyRemove(2);
+    assert(abst_18.countTombstones() == 0);
+    assert(abst_18.countNodes() == 13);
+    assert(abst_18.minValue() == 6);
+    assert(abst_18.getHeight() == 4);
+    // the minimum of 8's right subtree is a tombstone with a right child
+    assert(abst_18.tryRemove(10).value() == 10);
+    abst_18.lazyRemove(12);
+    assert(abst_18.countTombstones() == 1);
+    assert(abst_18.remove(rootIndex, 8) == 8);
+    assert(abst_18.countTombstones() == 1);
+    assert(abst_18.countNodes() == 10);
+    assert(vector<int>(abst_18.begin(), abst_18.end()) == vector<int>({6, 14, 16, 18, 20, 22, 24, 26, 28, 30}));
+    assert(abst_18.contains(12) == false);
+    assert(abst_18.rank(16) == 2);
+    assert(abst_18.select(1) == 14);
+    abst_18.compact();
+    assert(abst_18.countTombstones() == 0);
+    assert(abst_18.getHeight() == 4);
+
+    // test forEach traversals on
+    //        4
+    //      2   6
+    //     1 3 5 7
+    vector<int> keys_19 {1, 2, 3, 4, 5, 6, 7};
+    ArrayBST<int, 0, 1> abst_19;
+    abst_19.buildFromSorted(keys_19.data(), keys_19.size());
+    vector<int> visited;
+    auto record = [&visited](const int &value) { visited.push_back(value); };
+    assert(abst_19.forEachPreOrder(record) == true);
+    assert(visited == vector<int>({4, 2, 1, 3, 6, 5, 7}));
+    visited.clear();
+    abst_19.forEachInOrder(record);
+    assert(visited == vector<int>({1, 2, 3, 4, 5, 6, 7}));
+    visited.clear();
+    abst_19.forEachPostOrder(record);
+    assert(visited == vector<int>({1, 3, 2, 5, 7, 6, 4}));
+    visited.clear();
+    abst_19.forEachLevelOrder(record);
+    assert(visited == vector<int>({4, 2, 6, 1, 3, 5, 7}));
+    // a subtree only
+    visited.clear();
+    abst_19.forEachPreOrder(record, 3);
+    assert(visited == vector<int>({6, 5, 7}));
+    visited.clear();
+    abst_19.forEachInOrder(record, 2);
+    assert(visited == vector<int>({1, 2, 3}));
+    visited.clear();
+    abst_19.forEachPostOrder(record, 3);
+    assert(visited == vector<int>({5, 7, 6}));
+    // early exit
+    visited.clear();
+    bool finished = abst_19.forEachInOrder([&visited](const int &value) {
+        visited.push_back(value);
+        return value < 3;
+    });
+    assert(finished == false);
+    assert(visited == vector<int>({1, 2, 3}));
+    visited.clear();
+    assert(abst_19.forEachLevelOrder([&visited](const int &value) {
+        visited.push_back(value);
+        return value != 6;
+    }) == false);
+    assert(visited == vector<int>({4, 2, 6}));
+    // tombstones are skipped
+    abst_19.lazyRemove(2);
+    visited.clear();
+    abst_19.forEachPreOrder(record);
+    assert(visited == vector<int>({4, 1, 3, 6, 5, 7}));
+    visited.clear();
+    abst_19.forEachPostOrder(record);
+    assert(visited == vector<int>({1, 3, 5, 7, 6, 4}));
+
+    // test iterators: range-for, std algorithms, both directions, on a sparse tree
+    visited.clear();
+    for (int value : abst_3) {
+        visited.push_back(value);
+    }
+    assert(visited == vector<int>({2, 4, 5, 6, 28, 29, 30, 31, 32, 33, 34, 36, 38, 39, 40}));
+    assert(static_cast<size_t>(std::distance(abst_3.begin(), abst_3.end())) == abst_3.countNodes());
+    assert(std::is_sorted(abst_3.begin(), abst_3.end()));
+    assert(*std::find_if(abst_3.begin(), abst_3.end(), [](int value) { return value > 30; }) == 31);
+    assert(vector<int>(abst_3.rbegin(), abst_3.rend()) == vector<int>(visited.rbegin(), visited.rend()));
+    auto it = abst_3.end();
+    --it;
+    assert(*it == 40);
+    --it;
+    assert(*it == 39);
+    it++;
+    assert(*it == 40);
+    assert(++it == abst_3.end());
+    assert(vector<int>(abst_19.begin(), abst_19.end()) == vector<int>({1, 3, 4, 5, 6, 7}));
+    assert(vector<int>(abst_19.rbegin(), abst_19.rend()) == vector<int>({7, 6, 5, 4, 3, 1}));
+    assert(abst_1.begin() == abst_1.end());
+
+    // test order statistics, abst_19 holds 1 3 4 5 6 7 with 2 removed lazily
+    assert(abst_19.rank(4) == 2);
+    assert(abst_19.rank(2) == 1);
+    assert(abst_19.rank(100) == 6);
+    assert(abst_19.countInRange(2, 6) == 4);
+    assert(abst_19.countInRange(6, 2) == 0);
+    assert(abst_19.select(0) == 1);
+    assert(abst_19.select(1) == 3);
+    assert(abst_19.select(5) == 7);
+    visited.clear();
+    abst_19.collectRange(2, 5, std::back_inserter(visited));
+    assert(visited == vector<int>({3, 4, 5}));
+    thrown = false;
+    try {
+        abst_19.select(6);
+    } catch (const runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+
+    // test order statistics against std::multiset through inserts with duplicates and both removes
+    auto checkOrderStatistics = [&seed](auto &tree, int operations) {
+        const int rangeKeys = 300;
+        std::multiset<int> expected;
+        for (int i = 0; i < operations; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            int value = static_cast<int>((seed >> 16) % rangeKeys) + 1;
+            if (i % 3 != 2) {
+                tree.insert(value);
+                expected.insert(value);
+            } else if (i % 2 == 0) {
+                assert(tree.lazyRemove(value).has_value() == (expected.count(value) > 0));
+                if (expected.count(value) > 0) {
+                    expected.erase(expected.find(value));
+                }
+            } else {
+                assert(tree.tryRemove(value).has_value() == (expected.count(value) > 0));
+                if (expected.count(value) > 0) {
+                    expected.erase(expected.find(value));
+                }
+            }
+            if (i % 50 != 0) {
+                continue;
+            }
+            seed = seed * 1103515245u + 12345u;
+            int lo = static_cast<int>((seed >> 16) % rangeKeys);
+            int hi = lo + static_cast<int>((seed >> 8) % 40);
+            auto first = expected.lower_bound(lo);
+            auto last = expected.upper_bound(hi);
+            assert(tree.rank(lo) == static_cast<size_t>(std::distance(expected.begin(), first)));
+            assert(tree.countInRange(lo, hi) == static_cast<size_t>(std::distance(first, last)));
+            vector<int> collected;
+            tree.collectRange(lo, hi, std::back_inserter(collected));
+            assert(collected == vector<int>(first, last));
+            size_t k = 0;
+            for (int value : expected) {
+                assert(tree.select(k++) == value);
+            }
+        }
+    };
+    // fewer for the unbalanced tree, whose array doubles with every level a run of duplicates adds
+    ArrayBST<int, 0, 1> abst_20;
+    checkOrderStatistics(abst_20, 600);
+    ArrayBST<int, 0, 1, true> abst_21;
+    checkOrderStatistics(abst_21, 3000);
+
+    // test freeze: the snapshot answers lowerBound like the tree, in every kernel the CPU has
+    using Kernel = StaticKaryTree<int>::Kernel;
+    StaticKaryTree<int> frozen = abst_21.freeze();
+    assert(frozen.size() == abst_21.countNodes());
+    for (Kernel kernel : {Kernel::SCALAR, Kernel::SSE2, Kernel::AVX2}) {
+        if (!StaticKaryTree<int>::supports(kernel)) {
+            continue;
+        }
+        frozen.setKernel(kernel);
+        for (int value = -1; value <= 310; ++value) {
+            assert(frozen.lowerBound(value) == abst_21.lowerBound(value));
+        }
+    }
+    ArrayBST<int, 0, 1> abst_22;
+    assert(abst_22.freeze().lowerBound(1).has_value() == false);
+
+    // test StaticKaryTree on sizes around the node width, with duplicates and the padding value as a key
+    for (size_t n : {1, 15, 16, 17, 272, 289, 5000}) {
+        vector<int> sortedKeys(n);
+        for (size_t i = 0; i < n; ++i) {
+            sortedKeys[i] = static_cast<int>(i / 2) * 3;
+        }
+        sortedKeys[n - 1] = std::numeric_limits<int>::max();
+        StaticKaryTree<int> skt {sortedKeys.data(), n};
+        StaticKaryTree<int> copied {skt};
+        for (Kernel kernel : {Kernel::SCALAR, Kernel::SSE2, Kernel::AVX2}) {
+            if (!StaticKaryTree<int>::supports(kernel)) {
+                continue;
+            }
+            copied.setKernel(kernel);
+            for (int value = -2; value <= static_cast<int>(n) * 2; ++value) {
+                auto it = std::lower_bound(sortedKeys.begin(), sortedKeys.end(), value);
+                assert(copied.lowerBound(value) == *it);
+            }
+            assert(copied.contains(std::numeric_limits<int>::max()) == true);
+        }
+    }
+    vector<double> doubles {-1.5, 0.25, 0.25, 2.0, 8.0, 9.5, 11.0, 40.0, 41.0};
+    StaticKaryTree<double> doubleTree {doubles.data(), doubles.size()};
+    assert(doubleTree.getKernel() == StaticKaryTree<double>::Kernel::SCALAR);
+    assert(doubleTree.lowerBound(0.3) == 2.0);
+    assert(doubleTree.lowerBound(41.5).has_value() == false);
+    assert(doubleTree.contains(9.5) == true && doubleTree.contains(9.0) == false);
+    thrown = false;
+    try {
+        doubleTree.setKernel(StaticKaryTree<double>::Kernel::AVX2);
+    } catch (const runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+
+    // test bulkLoad: any thread count gives the tree buildFromSorted gives for the distinct keys
+    for (size_t n : {0, 1, 2, 5, 63, 64, 65, 1000, 100000}) {
+        vector<int> unsorted(n);
+        for (int &value : unsorted) {
+            seed = seed * 1103515245u + 12345u;
+            value = static_cast<int>((seed >> 8) % (n + 1)) + 1;
+        }
+        vector<int> distinct(unsorted);
+        std::sort(distinct.begin(), distinct.end());
+        distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+        ArrayBST<int, 0, 1> expected;
+        expected.buildFromSorted(distinct.data(), distinct.size());
+        for (size_t threads : {1, 2, 3, 8}) {
+            ArrayBST<int, 0, 1> loaded {5};
+            loaded.bulkLoad(unsorted.data(), unsorted.size(), threads);
+            assert(loaded == expected);
+            assert(loaded.countNodes() == distinct.size());
+            assert(vector<int>(loaded.begin(), loaded.end()) == distinct);
+            for (size_t k = 0; k < distinct.size(); k += 97) {
+                assert(loaded.select(k) == distinct[k]);
+                assert(loaded.rank(distinct[k]) == k);
+            }
+        }
+    }
+    ArrayBST<int, 0, 1> abst_23;
+    abst_23.bulkLoad(keys_19.data(), keys_19.size());
+    assert(abst_23.getHeight() == 3);
+    abst_23.insert(8);
+    assert(abst_23.countInRange(4, 8) == 5);
+    vector<int> withInitValue {3, 0, 1};
+    thrown = false;
+    try {
+        abst_23.bulkLoad(withInitValue.data(), withInitValue.size());
+    } catch (const runtime_error &e) {
+        thrown = true;
+    }
+    assert(thrown == true);
+    assert(abst_23.countNodes() == 8);
+
     return 0;
 }
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "../array_based/ArrayBST.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::string;
+
+static volatile int64_t checksumSink = 0;
+
+// returns milliseconds for one load
+template<typename Load>
+double runLoad(Load load) {
+    auto start = std::chrono::steady_clock::now();
+    int64_t checksum = load();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    checksumSink = checksum;
+    return elapsed.count();
+}
+
+int main(int argc, char **argv) {
+    size_t maxKeys = argc > 1 ? std::stoul(argv[1]) : 10000000;
+    size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+
+    cout << "keys,threads,bulk_load_ms,speedup" << endl;
+    for (size_t n = 100000; n <= maxKeys; n *= 10) {
+        // a scrambled dump with about one duplicate in eight
+        vector<int> keys(n);
+        uint64_t lcg = 42;
+        for (int &key : keys) {
+            lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+            key = static_cast<int>((lcg >> 33) % (4 * n)) + 1;
+        }
+
+        // the old way, one insert at a time into a balanced tree, too slow beyond 10^6 keys
+        cout << std::fixed << std::setprecision(2);
+        if (n <= 1000000) {
+            double inserted = runLoad([&keys]() {
+                ArrayBST<int, 0, 1, true> tree;
+                for (int key : keys) {
+                    tree.insert(key);
+                }
+                return static_cast<int64_t>(tree.countNodes());
+            });
+            cout << n << ",insert," << inserted << ",-" << endl;
+        }
+
+        // powers of two up to all cores
+        double single = 0;
+        for (size_t threads = 1; threads <= cores; threads = threads == cores ? cores + 1 : std::min(2 * threads, cores)) {
+            double loaded = runLoad([&keys, threads]() {
+                ArrayBST<int, 0, 1> tree;
+                tree.bulkLoad(keys.data(), keys.size(), threads);
+                return static_cast<int64_t>(tree.countNodes());
+            });
+            single = threads == 1 ? loaded : single;
+            cout << n << "," << threads << "," << loaded << "," << single / loaded << endl;
+        }
+    }
+
+    return 0;
+}
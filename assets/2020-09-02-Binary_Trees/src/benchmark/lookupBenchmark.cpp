@@ -0,0 +1,80 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include "../array_based/ArrayBST.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::string;
+
+static volatile int64_t checksumSink = 0;
+
+// returns nanoseconds per lookup
+template<typename Lookup>
+double runLookups(const vector<int> &queries, Lookup lookup) {
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int q : queries) {
+        checksum += lookup(q);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    checksumSink = checksum;
+    return elapsed.count() / queries.size();
+}
+
+int main(int argc, char **argv) {
+    size_t maxKeys = argc > 1 ? std::stoul(argv[1]) : 10000000;
+    const size_t queryCount = 2000000;
+
+    using Kernel = StaticKaryTree<int>::Kernel;
+    cout << "keys,std_lower_bound_ns,eytzinger_lower_bound_ns,kary_scalar_ns,kary_sse2_ns,kary_avx2_ns" << endl;
+    for (size_t n = 1000; n <= maxKeys; n *= 10) {
+        // odd keys, so half of the queries miss
+        vector<int> keys(n);
+        for (size_t i = 0; i < n; ++i) {
+            keys[i] = 2 * static_cast<int>(i) + 1;
+        }
+        vector<int> queries(queryCount);
+        uint64_t lcg = 42;
+        for (int &q : queries) {
+            lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+            q = static_cast<int>((lcg >> 33) % (2 * n + 2));
+        }
+
+        ArrayBST<int, 0, 1> tree;
+        tree.buildFromSorted(keys.data(), keys.size());
+
+        double sorted = runLookups(queries, [&keys](int q) {
+            auto it = std::lower_bound(keys.begin(), keys.end(), q);
+            return it == keys.end() ? -1 : *it;
+        });
+        double eytzinger = runLookups(queries, [&tree](int q) {
+            std::optional<int> ret = tree.lowerBound(q);
+            return ret ? *ret : -1;
+        });
+        cout << n << "," << std::fixed << std::setprecision(2) << sorted << "," << eytzinger;
+
+        // the frozen k-ary snapshot in every kernel, - where the CPU lacks one
+        StaticKaryTree<int> frozen = tree.freeze();
+        for (Kernel kernel : {Kernel::SCALAR, Kernel::SSE2, Kernel::AVX2}) {
+            if (!StaticKaryTree<int>::supports(kernel)) {
+                cout << ",-";
+                continue;
+            }
+            frozen.setKernel(kernel);
+            cout << "," << runLookups(queries, [&frozen](int q) {
+                std::optional<int> ret = frozen.lowerBound(q);
+                return ret ? *ret : -1;
+            });
+        }
+        cout << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <algorithm>
+#include "../array_based/ArrayBST.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::string;
+
+static volatile int64_t checksumSink = 0;
+
+// returns nanoseconds per query
+template<typename Query>
+double runQueries(const vector<int> &bounds, Query query) {
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int lo : bounds) {
+        checksum += query(lo);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    checksumSink = checksum;
+    return elapsed.count() / bounds.size();
+}
+
+int main(int argc, char **argv) {
+    size_t maxKeys = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const int width = 100;
+    const size_t queries = 1000;
+
+    cout << "keys,copy_and_count_ns,count_in_range_ns,collect_range_ns,select_ns" << endl;
+    for (size_t n = 1000; n <= maxKeys; n *= 10) {
+        // insert in a scrambled order, so the tree is sparse as in real use
+        ArrayBST<int, 0, 1, true> tree;
+        uint64_t lcg = 42;
+        for (size_t i = 0; i < n; ++i) {
+            lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+            tree.insert(static_cast<int>((lcg >> 33) % (4 * n)) + 1);
+        }
+        vector<int> bounds(queries);
+        for (int &lo : bounds) {
+            lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+            lo = static_cast<int>((lcg >> 33) % (4 * n));
+        }
+
+        // the old way: copy the tree out sorted and search the copy
+        double copied = runQueries(bounds, [&tree, width](int lo) {
+            vector<int> sorted(tree.begin(), tree.end());
+            auto first = std::lower_bound(sorted.begin(), sorted.end(), lo);
+            auto last = std::upper_bound(first, sorted.end(), lo + width);
+            return static_cast<int64_t>(last - first);
+        });
+        double counted = runQueries(bounds, [&tree, width](int lo) {
+            return static_cast<int64_t>(tree.countInRange(lo, lo + width));
+        });
+        vector<int> out;
+        double collected = runQueries(bounds, [&tree, &out, width](int lo) {
+            out.clear();
+            tree.collectRange(lo, lo + width, std::back_inserter(out));
+            return static_cast<int64_t>(out.size());
+        });
+        double selected = runQueries(bounds, [&tree, n](int lo) {
+            return static_cast<int64_t>(tree.select(static_cast<size_t>(lo) % n));
+        });
+        cout << n << "," << std::fixed << std::setprecision(2)
+             << copied << "," << counted << "," << collected << "," << selected << endl;
+    }
+
+    return 0;
+}
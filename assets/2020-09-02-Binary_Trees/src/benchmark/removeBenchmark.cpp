@@ -0,0 +1,80 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include "../array_based/ArrayBST.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::string;
+
+// removes every key of a balanced tree in random order, timing each call
+// returns the per-remove latencies in nanoseconds, sorted
+template<typename Remove>
+vector<double> runRemoves(const vector<int> &keys, const vector<int> &order, Remove remove) {
+    ArrayBST<int, 0, 1> tree;
+    tree.buildFromSorted(keys.data(), keys.size());
+    vector<double> latencies;
+    latencies.reserve(order.size());
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        auto start = std::chrono::steady_clock::now();
+        remove(tree, i, order[i]);
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        latencies.push_back(elapsed.count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+}
+
+void report(const string &name, size_t n, const vector<double> &latencies) {
+    double sum = 0;
+    for (double latency : latencies) {
+        sum += latency;
+    }
+    cout << name << "," << n << "," << std::fixed << std::setprecision(1)
+         << sum / latencies.size() << ","
+         << latencies[latencies.size() / 2] << ","
+         << latencies[latencies.size() * 999 / 1000] << ","
+         << latencies.back() << endl;
+}
+
+int main(int argc, char **argv) {
+    size_t maxKeys = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    cout << "remove,keys,mean_ns,p50_ns,p999_ns,max_ns" << endl;
+    for (size_t n = 10000; n <= maxKeys; n *= 10) {
+        vector<int> keys(n);
+        for (size_t i = 0; i < n; ++i) {
+            keys[i] = static_cast<int>(i) + 1;
+        }
+        // a Fisher-Yates shuffle with a fixed LCG, the same order for every run
+        vector<int> order {keys};
+        uint64_t lcg = 42;
+        for (size_t i = n - 1; i > 0; --i) {
+            lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+            std::swap(order[i], order[(lcg >> 33) % (i + 1)]);
+        }
+
+        report("eager", n, runRemoves(keys, order, [](ArrayBST<int, 0, 1> &tree, size_t, int value) {
+            tree.tryRemove(value);
+        }));
+        report("lazy", n, runRemoves(keys, order, [](ArrayBST<int, 0, 1> &tree, size_t, int value) {
+            tree.lazyRemove(value);
+        }));
+        // every other remove eager, so each one meets the tombstones the lazy ones left
+        report("mixed", n, runRemoves(keys, order, [](ArrayBST<int, 0, 1> &tree, size_t i, int value) {
+            if (i % 2 == 0) {
+                tree.lazyRemove(value);
+            } else {
+                tree.tryRemove(value);
+            }
+        }));
+    }
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include "../array_based/ArrayBST.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+using std::string;
+
+static volatile int64_t checksumSink = 0;
+
+// returns nanoseconds per node
+template<typename Walk>
+double runWalk(size_t n, Walk walk) {
+    auto start = std::chrono::steady_clock::now();
+    int64_t checksum = walk();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    checksumSink = checksum;
+    return elapsed.count() / n;
+}
+
+int main(int argc, char **argv) {
+    size_t maxKeys = argc > 1 ? std::stoul(argv[1]) : 10000000;
+
+    cout << "keys,print_in_order_ns,for_each_in_order_ns,iterator_ns,for_each_level_order_ns" << endl;
+    for (size_t n = 10000; n <= maxKeys; n *= 10) {
+        vector<int> keys(n);
+        for (size_t i = 0; i < n; ++i) {
+            keys[i] = static_cast<int>(i) + 1;
+        }
+        ArrayBST<int, 0, 1> tree;
+        tree.buildFromSorted(keys.data(), keys.size());
+
+        // the printing traversal, with cout sent to a string
+        std::ostringstream sink;
+        std::streambuf *coutBuffer = cout.rdbuf(sink.rdbuf());
+        double printed = runWalk(n, [&tree]() {
+            tree.inOrder(1);
+            return int64_t {0};
+        });
+        cout.rdbuf(coutBuffer);
+
+        double visited = runWalk(n, [&tree]() {
+            int64_t sum = 0;
+            tree.forEachInOrder([&sum](const int &value) { sum += value; });
+            return sum;
+        });
+        double iterated = runWalk(n, [&tree]() {
+            int64_t sum = 0;
+            for (int value : tree) {
+                sum += value;
+            }
+            return sum;
+        });
+        double levels = runWalk(n, [&tree]() {
+            int64_t sum = 0;
+            tree.forEachLevelOrder([&sum](const int &value) { sum += value; });
+            return sum;
+        });
+        cout << n << "," << std::fixed << std::setprecision(2)
+             << printed << "," << visited << "," << iterated << "," << levels << endl;
+    }
+
+    return 0;
+}
@@ -5,6 +5,8 @@
 #include <vector>
 #include <stdexcept>
 #include <map>
+#include <utility>
+#include <optional>
 
 using std::cout;
 using std::endl;
@@ -101,6 +103,10 @@ public:
 
     vector<int> getEdgeWeight(const pair<int, int> &edge);
 
+    // getEdgeWeight that reports a missing edge with std::nullopt instead of throwing
+    // a miss costs one lookup and no allocation
+    std::optional<vector<int>> tryGetEdgeWeight(const pair<int, int> &edge) const;
+
     void updateEdgeWeight(const pair<int, int> &edge, int weight);
 
     void displayAdjList();
@@ -316,13 +322,23 @@ void AdjacencyListDirectedGraph<T>::removeEdge(const pair<int, int> &edge) {
 
 template<typename T>
 vector<int> AdjacencyListDirectedGraph<T>::getEdgeWeight(const pair<int, int> &edge) {
+    std::optional<vector<int>> weights = tryGetEdgeWeight(edge);
     // check if the edge exists
-    if (edges.count(edge) == 0) {
+    if (!weights) {
         throw std::runtime_error("invalid getEdgeWeight: no edge between the vertices.");
     }
+    return std::move(*weights);
+}
+
+template<typename T>
+std::optional<vector<int>> AdjacencyListDirectedGraph<T>::tryGetEdgeWeight(const pair<int, int> &edge) const {
     // find all edges from startVertexId (edge.first) to endVertexId (edge.second)
-    typedef typename multimap<pair<int, int>, GraphEdge>::iterator MMAPIterator;
+    typedef typename multimap<pair<int, int>, GraphEdge>::const_iterator MMAPIterator;
     std::pair<MMAPIterator, MMAPIterator> bounds = edges.equal_range(edge);
+    if (bounds.first == bounds.second) {
+        // no edge, nothing allocated
+        return std::nullopt;
+    }
     // return the weights of all edges from startVertexId to endVertexId
     vector<int> weights;
     for (MMAPIterator it = bounds.first; it != bounds.second; ++it) {   // iterate over the range
@@ -125,6 +125,10 @@ int main() {
     }  catch (const std::runtime_error &e) {
         cout << e.what() << endl;
     }
+
+    // test tryGetEdgeWeight, a missing edge is not an exception
+    assert(graph_3.tryGetEdgeWeight(edge2update).value() == vector<int>({3, 3}));
+    assert(!graph_3.tryGetEdgeWeight(std::make_pair(100, 101)));
     cout << "=============================================================\n";
 
     // test removeEdge